@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+
+/**
+ * Times lookup of event topics in topic patterns, with few patterns and with 10k patterns.
+ * Lookup cost is expected to stay about the same, as it depends on topic levels only.
+ *
+ * Usage: cezmq_topic_pattern_bench [lookups]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "cezmqtopicpattern.h"
+
+using namespace ezmq;
+
+#define DEFAULT_LOOKUPS 1000000
+
+// Half of patterns take one level wildcard, other half the rest of topic.
+static void addPatterns(CEZMQTopicPatterns<int> &patterns, int count)
+{
+    for (int i = 0; i < count / 2; i++)
+    {
+        std::string site = "site/" + std::to_string(i) + "/*/temperature";
+        std::string area = "area/" + std::to_string(i) + "/#";
+        patterns.insert(site.c_str(), site.size(), i);
+        patterns.insert(area.c_str(), area.size(), i);
+    }
+}
+
+// Returns ns per lookup, matched is filled with number of topics having a pattern.
+static double timeMatch(const CEZMQTopicPatterns<int> &patterns, const std::vector<std::string> &topics,
+        int lookups, int &matched)
+{
+    matched = 0;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; i++)
+    {
+        const std::string &topic = topics[i % topics.size()];
+        if (patterns.match(topic.c_str(), topic.size()))
+        {
+            matched++;
+        }
+    }
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - begin;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / lookups;
+}
+
+int main(int argc, char *argv[])
+{
+    int lookups = (argc > 1) ? atoi(argv[1]) : DEFAULT_LOOKUPS;
+    if (lookups <= 0)
+    {
+        printf("Usage: %s [lookups]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Topics matching patterns present with either pattern count, and topics matching none.
+    std::vector<std::string> topics;
+    for (int i = 0; i < 100; i++)
+    {
+        topics.push_back("site/" + std::to_string(i * 37 % 5) + "/floor/temperature");
+        topics.push_back("area/" + std::to_string(i * 41 % 5) + "/a/b");
+        topics.push_back("site/" + std::to_string(i) + "/floor/humidity");
+        topics.push_back("other/" + std::to_string(i) + "/a");
+    }
+
+    const int counts[] = {10, 10000};
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+    {
+        CEZMQTopicPatterns<int> patterns;
+        addPatterns(patterns, counts[i]);
+        int matched = 0;
+        timeMatch(patterns, topics, (int) topics.size(), matched);
+        double cost = timeMatch(patterns, topics, lookups, matched);
+        // First two of every four topics match.
+        if (matched != (lookups / 4) * 2 + std::min(lookups % 4, 2))
+        {
+            printf("Unexpected match count %d of %d lookups\n", matched, lookups);
+            return EXIT_FAILURE;
+        }
+        printf("%zu patterns: %.1f ns/match, %d of %d topics matched\n", patterns.size(), cost,
+                matched, lookups);
+    }
+    return EXIT_SUCCESS;
+}
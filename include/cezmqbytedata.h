@@ -24,6 +24,8 @@
 #ifndef __EZMQ_BYTEDATA_H_INCLUDED__
 #define __EZMQ_BYTEDATA_H_INCLUDED__
 
+#include <sys/uio.h>
+
 #include "cezmqerrorcodes.h"
 
 #define EZMQ_EXPORT __attribute__ ((visibility("default")))
@@ -38,6 +40,14 @@ extern "C"
  */
 typedef void * ezmqByteDataHandle_t;
 
+/**
+ * Callback to free application buffer given to ezmqCreateLocalByteDataNoCopy.
+ *
+ * @param data - Buffer given to ezmqCreateLocalByteDataNoCopy.
+ * @param hint - Hint given to ezmqCreateLocalByteDataNoCopy.
+ */
+typedef void (*ezmqByteDataFreeCB)(uint8_t *data, void *hint);
+
 /**
  * Create ezmq byte data.
  *
@@ -48,9 +58,38 @@ typedef void * ezmqByteDataHandle_t;
 EZMQ_EXPORT CEZMQErrorCode ezmqCreateByteData(ezmqByteDataHandle_t *dataHandle, uint8_t * data,
         size_t dataLength);
 
+/**
+ * Create ezmq byte data referring to given buffer, for publishing on in-process and
+ * shared memory endpoints without copying it. Ownership of buffer is transferred to
+ * byte data and freeFn is called once buffer is no longer used.
+ *
+ * @param dataHandle -Given byte data handle will be filled as return value.
+ * @param data -Application buffer.
+ * @param dataLength -Length of application buffer.
+ * @param freeFn -Callback to free application buffer.
+ * @param hint -Hint to be passed to freeFn [Optional, can be NULL].
+ *
+ * @return CEZMQErrorCode -CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Application should not modify buffer after calling this API. <br>
+ * (2) In-process subscribers get the buffer itself and shared memory rings copy it into
+ *     their slots, no other copy is taken. <br>
+ * (3) EZMQ keeps its own copy of byte data for TCP socket. This copy is taken when the
+ *     byte data is published on TCP for the first time [By sender thread in case of
+ *     ezmqPublishAsync] and freeFn is called right after that. It is the same copy which
+ *     ezmqCreateByteData takes, so nothing is saved for TCP publishers. <br>
+ * (4) If byte data is never published on TCP, freeFn is called from ezmqDestroyByteData. <br>
+ * (5) On error, ownership of buffer remains with application.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqCreateLocalByteDataNoCopy(ezmqByteDataHandle_t *dataHandle,
+        uint8_t *data, size_t dataLength, ezmqByteDataFreeCB freeFn, void *hint);
+
 /**
  * Get data field of given byte data handle.
- * Note: Application should not free data.
+ * Note: Application should not free data. For byte data created using
+ * ezmqCreateLocalByteDataNoCopy, data got before it is published on TCP refers to application
+ * buffer, which is freed by that publish.
  *
  * @param dataHandle -byte data handle.
  * @param data -data will be filled as return value.
@@ -69,6 +108,21 @@ EZMQ_EXPORT CEZMQErrorCode ezmqGetByteData(ezmqByteDataHandle_t dataHandle, uint
  */
 EZMQ_EXPORT CEZMQErrorCode ezmqGetDataLength(ezmqByteDataHandle_t dataHandle, size_t *dataLength);
 
+/**
+ * Get segments of byte data published using ezmqPublishByteDataV. Segments refer to
+ * data of byte data and are valid as long as byte data is.
+ *
+ * @param dataHandle -byte data handle.
+ * @param segments -Array to be filled with segments, in the order they were published.
+ * @param count -Size of segments array, it will be filled with number of segments as return value.
+ *
+ * @return CEZMQErrorCode -CEZMQ_OK on success, CEZMQ_ERROR if byte data was not published
+ *         using ezmqPublishByteDataV or segments array is too small [count is filled with
+ *         number of segments in that case].
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqGetByteDataSegments(ezmqByteDataHandle_t dataHandle,
+        struct iovec *segments, int *count);
+
 /**
  * Destroy ezmq byte data. Application needs to call this API to delete/free ezmq byte data.
  *
@@ -39,7 +39,10 @@ typedef enum
     CEZMQ_OK = 0,
     CEZMQ_ERROR,
     CEZMQ_INVALID_TOPIC,
-    CEZMQ_INVALID_CONTENT_TYPE
+    CEZMQ_INVALID_CONTENT_TYPE,
+    CEZMQ_QUEUE_FULL,
+    CEZMQ_RATE_LIMITED,
+    CEZMQ_TIMEOUT
 } CEZMQErrorCode;
 
 /**
@@ -24,6 +24,8 @@
 #ifndef __EZMQ_EVENT_H_INCLUDED__
 #define __EZMQ_EVENT_H_INCLUDED__
 
+#include <stddef.h>
+
 #include "cezmqerrorcodes.h"
 
 #define EZMQ_EXPORT __attribute__ ((visibility("default")))
@@ -38,6 +40,85 @@ extern "C"
  */
 typedef void * ezmqEventHandle_t;
 
+/**
+ * Event pool handle
+ */
+typedef void * ezmqEventPoolHandle_t;
+
+/**
+ * Arena handle, memory block from which events and their readings are allocated.
+ */
+typedef void * ezmqArenaHandle_t;
+
+/**
+ * Event fields set using ezmqEventSetAll. NULL string sets empty value.
+ */
+typedef struct
+{
+    const char *id;                 /**< Id of event. */
+    long created;                   /**< Created time. */
+    long modified;                  /**< Modified time. */
+    long origin;                    /**< Origin time. */
+    long pushed;                    /**< Pushed time. */
+    const char *device;             /**< Device of event. */
+} CEZMQEventFields;
+
+/**
+ * Reading fields added using ezmqEventAddReadings. NULL string sets empty value.
+ */
+typedef struct
+{
+    const char *id;                 /**< Id of reading. */
+    long created;                   /**< Created time. */
+    long modified;                  /**< Modified time. */
+    long origin;                    /**< Origin time. */
+    long pushed;                    /**< Pushed time. */
+    const char *name;               /**< Name of reading. */
+    const char *value;              /**< Value of reading. */
+    const char *device;             /**< Device of reading. */
+} CEZMQReadingFields;
+
+/**
+ * Fields of a reading filled by ezmqEventGetReadings. Strings point into the event and are
+ * not NUL terminated copies, they are valid until event is changed or destroyed.
+ */
+typedef struct
+{
+    const char *id;                 /**< Id of reading. */
+    size_t idLength;                /**< Length of id. */
+    long created;                   /**< Created time. */
+    long modified;                  /**< Modified time. */
+    long origin;                    /**< Origin time. */
+    long pushed;                    /**< Pushed time. */
+    const char *name;               /**< Name of reading. */
+    size_t nameLength;              /**< Length of name. */
+    const char *value;              /**< Value of reading. */
+    size_t valueLength;             /**< Length of value. */
+    const char *device;             /**< Device of reading. */
+    size_t deviceLength;            /**< Length of device. */
+} CEZMQReadingView;
+
+/**
+ * Caller owned arrays filled by ezmqEventGetReadingColumns, element i of each array is of
+ * reading i. Arrays left NULL are not filled. Strings are valid same as CEZMQReadingView.
+ */
+typedef struct
+{
+    int capacity;                   /**< Number of elements of each array. */
+    const char **ids;               /**< Ids of readings. */
+    size_t *idLengths;              /**< Lengths of ids. */
+    const char **names;             /**< Names of readings. */
+    size_t *nameLengths;            /**< Lengths of names. */
+    const char **values;            /**< Values of readings. */
+    size_t *valueLengths;           /**< Lengths of values. */
+    const char **devices;           /**< Devices of readings. */
+    size_t *deviceLengths;          /**< Lengths of devices. */
+    long *created;                  /**< Created times. */
+    long *modified;                 /**< Modified times. */
+    long *origin;                   /**< Origin times. */
+    long *pushed;                   /**< Pushed times. */
+} CEZMQReadingColumns;
+
 /**
  * Get Id field of given event handle.
  * Note: Application should not free value.
@@ -121,6 +202,42 @@ EZMQ_EXPORT CEZMQErrorCode ezmqEventGetReadingCount(ezmqEventHandle_t eventHandl
  */
 EZMQ_EXPORT CEZMQErrorCode ezmqEventGetReading(ezmqEventHandle_t eventHandle, int index, void **value);
 
+/**
+ * Get fields of all the readings of given event handle in one call.
+ *
+ * @param eventHandle - Event handle.
+ * @param out - Array of views to be filled, can be NULL if capacity is 0.
+ * @param capacity - Number of views in array.
+ * @param count - Number of readings of event will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) First min(capacity, count) readings are filled. If count is more than capacity,
+ *     call again with a larger array. <br>
+ * (2) Application should not free strings of views.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqEventGetReadings(ezmqEventHandle_t eventHandle, CEZMQReadingView *out,
+        int capacity, int *count);
+
+/**
+ * Get fields of all the readings of given event handle as separate arrays per field.
+ *
+ * @param eventHandle - Event handle.
+ * @param columns - Arrays to be filled.
+ * @param count - Number of readings of event will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) First min(columns->capacity, count) readings are filled, same as
+ *     ezmqEventGetReadings. <br>
+ * (2) Contiguous arrays of a field, for example values or created times, can be processed
+ *     without walking reading handles.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqEventGetReadingColumns(ezmqEventHandle_t eventHandle,
+        const CEZMQReadingColumns *columns, int *count);
+
 /**
  * Initialize ezmq event. Application needs to call this API to create ezmq event.
  *
@@ -137,6 +254,9 @@ EZMQ_EXPORT CEZMQErrorCode ezmqCreateEvent(ezmqEventHandle_t *eventHandle);
  * @param eventHandle - Event handle.
  *
  * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note CEZMQ_ERROR is returned for event created in arena, it is freed by ezmqArenaReset
+ *       or ezmqDestroyArena.
  */
 EZMQ_EXPORT CEZMQErrorCode ezmqDestroyEvent(ezmqEventHandle_t *eventHandle);
 
@@ -200,6 +320,137 @@ EZMQ_EXPORT CEZMQErrorCode ezmqEventSetPushed(ezmqEventHandle_t eventHandle, lon
  */
 EZMQ_EXPORT CEZMQErrorCode ezmqEventSetDevice(ezmqEventHandle_t eventHandle, const char *value);
 
+/**
+ * Set all the fields of given event handle in one call.
+ *
+ * @param eventHandle - Event handle.
+ * @param fields - Fields to be set.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note Readings of event are not changed, see ezmqEventAddReadings.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqEventSetAll(ezmqEventHandle_t eventHandle, const CEZMQEventFields *fields);
+
+/**
+ * Add readings with given fields to event handle in one call.
+ *
+ * @param eventHandle - Event handle.
+ * @param readings - Array of fields of readings to be added.
+ * @param count - Number of readings in array.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Readings are appended after existing readings of event, space for all of them is
+ *     reserved once. <br>
+ * (2) Added readings can be changed using ezmqEventGetReading and reading setters.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqEventAddReadings(ezmqEventHandle_t eventHandle,
+        const CEZMQReadingFields *readings, int count);
+
+/**
+ * Create pool of events, reused instead of being created and destroyed for each publish.
+ *
+ * @param size - Max number of released events kept by pool, created up front.
+ * @param poolHandle - Pool handle will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqCreateEventPool(int size, ezmqEventPoolHandle_t *poolHandle);
+
+/**
+ * Destroy event pool and events kept by it.
+ *
+ * @param poolHandle - Pool handle.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note Events acquired and not yet released are not destroyed, application should destroy
+ *       them using ezmqDestroyEvent.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqDestroyEventPool(ezmqEventPoolHandle_t *poolHandle);
+
+/**
+ * Take an empty event from pool, a new event is created if pool has none.
+ *
+ * @param poolHandle - Pool handle.
+ * @param eventHandle - Event handle will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqEventPoolAcquire(ezmqEventPoolHandle_t poolHandle,
+        ezmqEventHandle_t *eventHandle);
+
+/**
+ * Give event back to pool. Event is cleared and kept for reuse, or destroyed if pool is full.
+ *
+ * @param poolHandle - Pool handle.
+ * @param eventHandle - Event handle, set to NULL.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Clearing keeps readings and string buffers of event allocated. Readings added to
+ *     acquired event reuse them, so publishing events of same shape allocates nothing once
+ *     pool is warm. <br>
+ * (2) Any event can be released, including event created using ezmqCreateEvent. Reading
+ *     handles of event should not be used after release. <br>
+ * (3) Pool is thread safe.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqEventPoolRelease(ezmqEventPoolHandle_t poolHandle,
+        ezmqEventHandle_t *eventHandle);
+
+/**
+ * Create arena for events. Events created in arena and their readings and strings are
+ * allocated from large blocks of arena, and are all freed at once by ezmqArenaReset.
+ *
+ * @param blockSize - Size of first block in bytes, kept across resets. 0 for none, blocks
+ *                    are then allocated as needed and freed by every reset.
+ * @param arenaHandle - Arena handle will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqCreateArena(size_t blockSize, ezmqArenaHandle_t *arenaHandle);
+
+/**
+ * Destroy arena, freeing all the events created in it.
+ *
+ * @param arenaHandle - Arena handle.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqDestroyArena(ezmqArenaHandle_t *arenaHandle);
+
+/**
+ * Create event in given arena.
+ *
+ * @param arenaHandle - Arena handle.
+ * @param eventHandle - Event handle will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Event is valid until arena is reset or destroyed. APIs taking ownership of event
+ *     [ezmqDestroyEvent, ezmqEventPoolRelease, ezmqPublishAsync, ezmqEventFreeze] return
+ *     CEZMQ_ERROR for it. <br>
+ * (2) Events can be created in same arena from many threads.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqCreateEventInArena(ezmqArenaHandle_t arenaHandle,
+        ezmqEventHandle_t *eventHandle);
+
+/**
+ * Free all the events created in arena at once. First block of arena is kept for events
+ * created next, so batches fitting in it allocate nothing in steady state.
+ *
+ * @param arenaHandle - Arena handle.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note No event of arena should be in use, including by publish on another thread.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqArenaReset(ezmqArenaHandle_t arenaHandle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,11 +24,23 @@
 #ifndef __EZMQ_PUB_H_INCLUDED__
 #define __EZMQ_PUB_H_INCLUDED__
 
+#include <stdint.h>
+#include <sys/uio.h>
+
 #include "cezmqerrorcodes.h"
 #include "cezmqevent.h"
+#include "cezmqtopic.h"
 
 #define EZMQ_EXPORT __attribute__ ((visibility("default")))
 
+/**
+ * Default and max size of shared memory ring of shm endpoint.
+ */
+#define CEZMQ_SHM_SLOT_COUNT 1024
+#define CEZMQ_SHM_SLOT_SIZE 4096
+#define CEZMQ_SHM_MAX_SLOT_COUNT (1 << 20)
+#define CEZMQ_SHM_MAX_SLOT_SIZE (16 << 20)
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -39,14 +51,62 @@ extern "C"
  */
 typedef void * ezmqPubHandle_t;
 
+/**
+ * Prepared message handle
+ */
+typedef void * ezmqPreparedMsgHandle_t;
+
 /**
  * Callbacks to get error codes for start/stop of EZMQ publisher.
- * Note: As of now not being used.
+ * Note: As of now start/stop callbacks are not being used. Error callback is
+ * called from sender thread if publishing of an asynchronous event fails.
  */
 typedef void (*ezmqStartCB)(CEZMQErrorCode code);
 typedef void (*ezmqStopCB)(CEZMQErrorCode code);
 typedef void (*ezmqErrorCB)(CEZMQErrorCode code);
 
+/**
+* @enum CEZMQQueuePolicy
+* Behavior of asynchronous publish when sender queue is full or events are conflated.
+*/
+typedef enum
+{
+    CEZMQ_QUEUE_BLOCK = 0,
+    CEZMQ_QUEUE_DROP_NEWEST,
+    CEZMQ_QUEUE_DROP_OLDEST,
+    CEZMQ_QUEUE_CONFLATE
+} CEZMQQueuePolicy;
+
+/**
+ * Token bucket rate limit. Rate of 0 means that dimension is not limited and
+ * burst of 0 allows one second worth of messages/bytes in a burst.
+ */
+typedef struct
+{
+    uint32_t messagesPerSecond;
+    uint32_t messageBurst;
+    uint64_t bytesPerSecond;
+    uint64_t byteBurst;
+} CEZMQRateLimit;
+
+/**
+ * Version of publisher options structure known to this library.
+ */
+#define CEZMQ_PUB_OPTIONS_VERSION 1
+
+/**
+ * Publisher options. Initialize using ezmqInitPubOptions before changing the fields so
+ * that fields added in later versions get their defaults. Options size the queue of this
+ * library in front of EZMQ publisher, no socket options are set.
+ */
+typedef struct
+{
+    int version;                        /**< Version of structure, set by ezmqInitPubOptions. */
+    int asyncQueueSize;                 /**< Max events of ezmqPublishAsync waiting to be sent, 0 for none. */
+    CEZMQQueuePolicy asyncQueuePolicy;  /**< Behavior of ezmqPublishAsync when queue is full. */
+    int flushTimeout;                   /**< Time [in milliseconds] ezmqStopPublisher waits for queued events. */
+} CEZMQPubOptions;
+
 /**
  *  Create ezmq Publisher with given port and callbacks.
  *
@@ -61,6 +121,90 @@ typedef void (*ezmqErrorCB)(CEZMQErrorCode code);
 EZMQ_EXPORT CEZMQErrorCode ezmqCreatePublisher(int port, ezmqStartCB startCb,
         ezmqStopCB stopCb, ezmqErrorCB errorCb, ezmqPubHandle_t *pubHandle);
 
+/**
+ * Create ezmq Publisher bound to given endpoints.
+ *
+ * @param endpoints - Endpoints to publish on: "inproc://name", "shm://name" and/or tcp endpoint
+ *                    listening on all interfaces [tcp:// followed by *:port].
+ * @param count - Number of endpoints.
+ * @param startCb - Start callback.
+ * @param stopCb - Stop Callback.
+ * @param errorCb - Error Callback.
+ * @param pubHandle  - Handle to be filled.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) At most one tcp endpoint can be given. Any number of inproc endpoints can be given. <br>
+ * (2) Inproc endpoints are bound on ezmqStartPublisher, which returns CEZMQ_ERROR if an
+ *     endpoint is already bound by another publisher. <br>
+ * (3) Events published on inproc endpoints are delivered to connected subscribers on the
+ *     publishing thread, without serialization. <br>
+ * (4) Events published on shm endpoints are serialized into a shared memory ring
+ *     [/dev/shm/cezmq-name] created on ezmqStartPublisher and removed on ezmqDestroyPublisher.
+ *     Subscribers on the same host read the ring without syscalls. Oldest events are
+ *     overwritten when ring is full, slow subscribers miss them. Publishing an event bigger
+ *     than ring slot returns CEZMQ_ERROR. Ring of same name created by another publisher
+ *     is replaced. <br>
+ * (5) ipc endpoints are not supported by EZMQ library, CEZMQ_ERROR is returned for them. <br>
+ * (6) ezmqSetServerPrivateKey and ezmqGetPubPort return CEZMQ_ERROR for publisher without
+ *     tcp endpoint.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqCreatePublisherWithEndpoints(const char **endpoints, int count,
+        ezmqStartCB startCb, ezmqStopCB stopCb, ezmqErrorCB errorCb, ezmqPubHandle_t *pubHandle);
+
+/**
+ * Initialize publisher options with default values.
+ *
+ * @param options - Options to be initialized.
+ * @param version - Version of options structure, CEZMQ_PUB_OPTIONS_VERSION of the header
+ *                  application is built with.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Version is set in options and only fields defined by that version are written, so a
+ *     structure of older version can be given. CEZMQ_ERROR is returned for unknown version.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqInitPubOptions(CEZMQPubOptions *options, int version);
+
+/**
+ * Create ezmq Publisher with given port, options and callbacks.
+ *
+ * @param port - Port to be used for publisher socket.
+ * @param options - Publisher options.
+ * @param startCb - Start callback.
+ * @param stopCb - Stop Callback.
+ * @param errorCb - Error Callback.
+ * @param pubHandle  - Handle to be filled.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) asyncQueueSize > 0 is same as calling ezmqSetPublisherAsync with asyncQueueSize,
+ *     asyncQueuePolicy and flushTimeout. <br>
+ * (2) asyncQueueSize bounds only events published using ezmqPublishAsync. Other publish
+ *     APIs send on the calling thread and are not bounded by this library. <br>
+ * (3) No socket options are set. Socket level options of EZMQ publisher [zmq HWM, buffers,
+ *     keepalive] are owned by EZMQ library.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqCreatePublisherEx(int port, const CEZMQPubOptions *options,
+        ezmqStartCB startCb, ezmqStopCB stopCb, ezmqErrorCB errorCb, ezmqPubHandle_t *pubHandle);
+
+/**
+ * Get effective options of given publisher.
+ *
+ * @param pubHandle - Publisher handle
+ * @param options - Options will be filled as return value [initialized by ezmqInitPubOptions].
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) asyncQueueSize is rounded up to power of two. <br>
+ * (2) For publisher without async queue, asyncQueueSize and flushTimeout are 0.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqGetPubOptions(ezmqPubHandle_t pubHandle, CEZMQPubOptions *options);
+
 /**
  * Set the server private/secret key.
  *
@@ -77,6 +221,107 @@ EZMQ_EXPORT CEZMQErrorCode ezmqCreatePublisher(int port, ezmqStartCB startCb,
 EZMQ_EXPORT CEZMQErrorCode ezmqSetServerPrivateKey(ezmqPubHandle_t pubHandle,
         const char *key);
 
+/**
+ * Set size of shared memory ring of shm endpoints.
+ *
+ * @param pubHandle - Publisher handle.
+ * @param slotCount - Number of events kept in ring, rounded up to power of two.
+ * @param slotSize - Max size of an event in ring [topic and serialized event], rounded up
+ *                   to multiple of 64 bytes.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) This API should be called before ezmqStartPublisher. <br>
+ * (2) Default is CEZMQ_SHM_SLOT_COUNT slots of CEZMQ_SHM_SLOT_SIZE bytes.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqSetPublisherShmSize(ezmqPubHandle_t pubHandle, int slotCount,
+        int slotSize);
+
+/**
+ * Enable asynchronous publishing for the given publisher. Events published using
+ * ezmqPublishAsync are put in a bounded queue and sent to socket by a dedicated
+ * sender thread, so application thread does not wait for serialization and socket send.
+ *
+ * @param pubHandle - Publisher handle
+ * @param queueSize - Maximum number of events waiting in queue [Rounded up to power of two].
+ * @param policy - Behavior of ezmqPublishAsync when queue is full.
+ * @param flushTimeout - Time [in milliseconds] ezmqStopPublisher waits for queued events to be sent.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) This API should be called before start() API and only once for a publisher. <br>
+ * (2) Events still in queue after flushTimeout are discarded on stop. <br>
+ * (3) With CEZMQ_QUEUE_CONFLATE, queue holds at most one event per topic: event published
+ *     on a topic which is still waiting in queue replaces the waiting event [Events without
+ *     topic are conflated among themselves]. Replaced events are destroyed and counted in
+ *     ezmqGetPubDroppedCount. queueSize is then the maximum number of topics waiting in queue,
+ *     beyond that ezmqPublishAsync returns CEZMQ_QUEUE_FULL.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqSetPublisherAsync(ezmqPubHandle_t pubHandle, int queueSize,
+        CEZMQQueuePolicy policy, int flushTimeout);
+
+/**
+ * Set rate limit for all the events published using given publisher.
+ *
+ * @param pubHandle - Publisher handle
+ * @param limit - Rate limit, all zero values remove the limit.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Synchronous publish APIs return CEZMQ_RATE_LIMITED for events over the limit. <br>
+ * (2) Asynchronous events are paced: sender thread waits till event is within the limit. <br>
+ * (3) Event published on list/set of topics is counted once for every topic. <br>
+ * (4) Byte limit is applied on event size [Serialized size of protobuf event].
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqSetPublisherRateLimit(ezmqPubHandle_t pubHandle,
+        const CEZMQRateLimit *limit);
+
+/**
+ * Set rate limit for the events published on topic of given topic handle. Limit is applied
+ * in addition to the publisher rate limit, in the same way.
+ *
+ * @param topicHandle - Topic handle created using ezmqCreateTopic.
+ * @param limit - Rate limit, all zero values remove the limit.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Limit is applied to the events published on the topic by topic handle or by topic
+ *     name, as long as a handle of the topic exists. Events published on list/set of
+ *     topics are limited by publisher rate limit only. <br>
+ * (2) Limit is shared by all the handles of same topic and by all the publishers. <br>
+ * (3) Events rejected for invalid topic or content type do not take any rate.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqSetTopicRateLimit(ezmqTopicHandle_t topicHandle,
+        const CEZMQRateLimit *limit);
+
+/**
+ * Get number of times publisher rate limit kicked in.
+ *
+ * @param pubHandle - Publisher handle
+ * @param rejected - Number of events rejected with CEZMQ_RATE_LIMITED will be filled.
+ * @param paced - Number of asynchronous events delayed by sender thread will be filled.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqGetPubRateLimitCount(ezmqPubHandle_t pubHandle,
+        uint64_t *rejected, uint64_t *paced);
+
+/**
+ * Get number of times topic rate limit kicked in.
+ *
+ * @param topicHandle - Topic handle
+ * @param rejected - Number of events rejected with CEZMQ_RATE_LIMITED will be filled.
+ * @param paced - Number of asynchronous events delayed by sender thread will be filled.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqGetTopicRateLimitCount(ezmqTopicHandle_t topicHandle,
+        uint64_t *rejected, uint64_t *paced);
+
 /**
  * Starts PUB instance.
  *
@@ -131,6 +376,201 @@ EZMQ_EXPORT CEZMQErrorCode ezmqPublishOnTopic(ezmqPubHandle_t pubHandle, const c
 EZMQ_EXPORT CEZMQErrorCode ezmqPublishOnTopicList(ezmqPubHandle_t pubHandle, const char ** topicList,
         int listSize, const ezmqMsgHandle_t event);
 
+/**
+ * Publish an event on the topic of given topic handle. Topic is already validated
+ * while creating the handle so it is not parsed again.
+ *
+ * @param pubHandle - Publisher handle
+ * @param topicHandle - Topic handle created using ezmqCreateTopic.
+ * @param event - event to be published.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqPublishOnTopicHandle(ezmqPubHandle_t pubHandle,
+        ezmqTopicHandle_t topicHandle, const ezmqMsgHandle_t event);
+
+/**
+ * Publish an event on all the topics of given topic set. Same as
+ * ezmqPublishOnTopicList but topic list is not built and validated for every event.
+ *
+ * @param pubHandle - Publisher handle
+ * @param topicSet - Topic set handle created using ezmqCreateTopicSet.
+ * @param event - event to be published.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note Event is serialized once for all the topics and shared memory endpoints of
+ *       publisher. TCP socket is handled by EZMQ, which serializes the event itself.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqPublishOnTopicSet(ezmqPubHandle_t pubHandle,
+        ezmqTopicSetHandle_t topicSet, const ezmqMsgHandle_t event);
+
+/**
+ * Publish byte data gathered from multiple buffers as one message, which carries the
+ * length of every buffer. Application does not need to concatenate the buffers or create
+ * byte data for them.
+ *
+ * @param pubHandle - Publisher handle
+ * @param topic - Topic on which data needs to be published [Optional, can be NULL].
+ * @param iov - Buffers to be published, in order.
+ * @param iovcnt - Number of buffers in iov.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Subscribers receive a single byte data [CEZMQ_CONTENT_TYPE_BYTEDATA], its buffers
+ *     are got in iov order using ezmqGetByteDataSegments. <br>
+ * (2) Buffers are gathered once. In-process and shared memory endpoints read the gathered
+ *     data in place, EZMQ takes one more copy of it for TCP socket. <br>
+ * (3) Buffers can be reused by application as soon as this API returns. <br>
+ * (4) Topic name should be as path format. For example: home/livingroom/  <br>
+ * (5) Topic name can have letters [a-z, A-z], numerics [0-9] and special characters _ - . and /
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqPublishByteDataV(ezmqPubHandle_t pubHandle, const char *topic,
+        const struct iovec *iov, int iovcnt);
+
+/**
+ * Publish a batch of events on the socket for subscribers. Publisher handle is
+ * validated once for the whole batch. Failure of an event does not stop publishing
+ * of the remaining events, result of every event is filled in results array.
+ *
+ * @param pubHandle - Publisher handle
+ * @param topics - Topics on which events needs to be published [Optional, can be NULL].
+ * @param events - Events to be published.
+ * @param count - Number of events in the batch.
+ * @param results - Result of each event will be filled [Optional, can be NULL].
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK if all the events are published, otherwise CEZMQ_ERROR.
+ *
+ * @note
+ * (1) If topics is not NULL, topics[i] is used for events[i] and it should have count entries. <br>
+ *     NULL entry in topics means event will be published without topic. <br>
+ * (2) Topic name should be as path format. For example: home/livingroom/  <br>
+ * (3) Topic name can have letters [a-z, A-z], numerics [0-9] and special characters _ - . and /
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqPublishBatch(ezmqPubHandle_t pubHandle, const char **topics,
+        ezmqMsgHandle_t *events, int count, CEZMQErrorCode *results);
+
+/**
+ * Publish event asynchronously. Ownership of the event is transferred to publisher
+ * on success and it will be destroyed by sender thread after it is sent.
+ *
+ * @param pubHandle - Publisher handle
+ * @param topic - Topic on which event needs to be published [Optional, can be NULL].
+ * @param event - event to be published.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, CEZMQ_QUEUE_FULL if event is dropped
+ *         as per CEZMQ_QUEUE_DROP_NEWEST policy, otherwise appropriate error code.
+ *
+ * @note
+ * (1) ezmqSetPublisherAsync should be called before using this API. <br>
+ * (2) On any error ownership of event remains with application. <br>
+ * (3) This API can be called from multiple application threads on same publisher handle. <br>
+ * (4) Topic is validated by sender thread, failure is notified through error callback. <br>
+ * (5) CEZMQ_ERROR is returned for event created in arena, as arena frees it.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqPublishAsync(ezmqPubHandle_t pubHandle, const char *topic,
+        ezmqMsgHandle_t event);
+
+/**
+ * Publish event asynchronously on the topic of given topic handle. Behaves same as
+ * ezmqPublishAsync, topic handle is kept alive by publisher till event is sent.
+ *
+ * @param pubHandle - Publisher handle
+ * @param topicHandle - Topic handle created using ezmqCreateTopic.
+ * @param event - event to be published.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, CEZMQ_QUEUE_FULL if event is dropped
+ *         as per CEZMQ_QUEUE_DROP_NEWEST policy, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Application can destroy topic handle right after this API returns.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqPublishAsyncOnTopicHandle(ezmqPubHandle_t pubHandle,
+        ezmqTopicHandle_t topicHandle, ezmqMsgHandle_t event);
+
+/**
+ * Create prepared message from the given event/byte data. Prepared message is an
+ * immutable copy which can be published any number of times on any topic, from any
+ * thread, without copying it again.
+ *
+ * @param event - event/byte data to be copied.
+ * @param prepared - Prepared message handle will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Event is serialized once here, shared memory endpoints get the serialized bytes
+ *     on every publish and in-process endpoints get the event itself. <br>
+ * (2) EZMQ serializes the event for TCP socket on every publish.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqCreatePreparedMessage(const ezmqMsgHandle_t event,
+        ezmqPreparedMsgHandle_t *prepared);
+
+/**
+ * Freeze the given event into prepared message. Ownership of event is transferred to
+ * prepared message without copying it and event handle is set to NULL. Event is
+ * serialized once, same as ezmqCreatePreparedMessage.
+ *
+ * @param eventHandle - Event handle to be frozen.
+ * @param prepared - Prepared message handle will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note CEZMQ_ERROR is returned for event created in arena, use ezmqCreatePreparedMessage
+ *       to copy it instead.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqEventFreeze(ezmqEventHandle_t *eventHandle,
+        ezmqPreparedMsgHandle_t *prepared);
+
+/**
+ * Publish prepared message on the socket for subscribers.
+ *
+ * @param pubHandle - Publisher handle
+ * @param topic - Topic on which message needs to be published [Optional, can be NULL].
+ * @param prepared - Prepared message to be published.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqPublishPrepared(ezmqPubHandle_t pubHandle, const char *topic,
+        ezmqPreparedMsgHandle_t prepared);
+
+/**
+ * Publish prepared message asynchronously. Sender queue holds a reference of the
+ * prepared message, application can keep using and publishing it.
+ *
+ * @param pubHandle - Publisher handle
+ * @param topic - Topic on which message needs to be published [Optional, can be NULL].
+ * @param prepared - Prepared message to be published.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, CEZMQ_QUEUE_FULL if message is dropped
+ *         as per CEZMQ_QUEUE_DROP_NEWEST policy, otherwise appropriate error code.
+ *
+ * @note ezmqSetPublisherAsync should be called before using this API.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqPublishPreparedAsync(ezmqPubHandle_t pubHandle, const char *topic,
+        ezmqPreparedMsgHandle_t prepared);
+
+/**
+ * Destroy prepared message. Message is freed once it is not referenced by
+ * any asynchronous publish.
+ *
+ * @param prepared - Prepared message handle.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqDestroyPreparedMessage(ezmqPreparedMsgHandle_t *prepared);
+
+/**
+ * Wait until all the asynchronous events are sent or timeout is elapsed.
+ *
+ * @param pubHandle - Publisher handle
+ * @param timeout - Maximum time to wait in milliseconds.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK if queue is empty, otherwise CEZMQ_ERROR.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqFlushPublisher(ezmqPubHandle_t pubHandle, int timeout);
+
 /**
  * Stops PUB instance.
  *
@@ -140,6 +580,26 @@ EZMQ_EXPORT CEZMQErrorCode ezmqPublishOnTopicList(ezmqPubHandle_t pubHandle, con
  */
 EZMQ_EXPORT CEZMQErrorCode ezmqStopPublisher(ezmqPubHandle_t pubHandle);
 
+/**
+* Get number of asynchronous events which are queued or being sent.
+*
+* @param pubHandle - Publisher handle
+* @param size - Number of events will be filled as return value.
+*
+* @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+*/
+EZMQ_EXPORT CEZMQErrorCode ezmqGetPubQueueSize(ezmqPubHandle_t pubHandle, int *size);
+
+/**
+* Get number of asynchronous events dropped because of full queue or stop.
+*
+* @param pubHandle - Publisher handle
+* @param count - Dropped events count will be filled as return value.
+*
+* @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+*/
+EZMQ_EXPORT CEZMQErrorCode ezmqGetPubDroppedCount(ezmqPubHandle_t pubHandle, uint64_t *count);
+
 /**
 * Get the port of the publisher.
 *
@@ -24,6 +24,9 @@
 #ifndef __EZMQ_READING_H_INCLUDED__
 #define __EZMQ_READING_H_INCLUDED__
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "cezmqerrorcodes.h"
 #include "cezmqevent.h"
 
@@ -39,6 +42,18 @@ extern "C"
  */
 typedef void *  ezmqReadingHandle_t;
 
+/**
+ * Type of value of reading.
+ */
+typedef enum
+{
+    CEZMQ_VALUE_STRING = 0,     /**< Only string value field, see ezmqReadingGetValue. */
+    CEZMQ_VALUE_DOUBLE,         /**< Typed double value. */
+    CEZMQ_VALUE_INT64,          /**< Typed 64 bit integer value. */
+    CEZMQ_VALUE_BOOL,           /**< Typed boolean value. */
+    CEZMQ_VALUE_BYTES           /**< Typed byte array value. */
+} CEZMQValueType;
+
 /**
  * Get Id field of given reading handle.
  * Note: Application should not free value.
@@ -214,6 +229,115 @@ EZMQ_EXPORT CEZMQErrorCode ezmqReadingSetValue(ezmqReadingHandle_t readingHandle
  */
 EZMQ_EXPORT CEZMQErrorCode ezmqReadingSetDevice(ezmqReadingHandle_t readingHandle, const char *value);
 
+/**
+ * Set typed double value of given reading handle.
+ *
+ * @param readingHandle - Reading handle.
+ * @param value - value to be set.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Reading has one typed value, setting a typed value replaces typed value of other type.
+ *     String value field is not changed, application can still set it for subscribers
+ *     using ezmqReadingGetValue. <br>
+ * (2) Typed value is sent in binary form, so subscriber gets it without parsing text. It is
+ *     carried in reading fields 9 to 12, kept by subscribers as unknown fields, which needs
+ *     protobuf 3.5 or later for proto3 messages received on tcp.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqReadingSetDouble(ezmqReadingHandle_t readingHandle, double value);
+
+/**
+ * Set typed 64 bit integer value of given reading handle.
+ *
+ * @param readingHandle - Reading handle.
+ * @param value - value to be set.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note See ezmqReadingSetDouble.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqReadingSetInt64(ezmqReadingHandle_t readingHandle, int64_t value);
+
+/**
+ * Set typed boolean value of given reading handle.
+ *
+ * @param readingHandle - Reading handle.
+ * @param value - value to be set, non zero for true.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note See ezmqReadingSetDouble.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqReadingSetBool(ezmqReadingHandle_t readingHandle, int value);
+
+/**
+ * Set typed byte array value of given reading handle, data is copied.
+ *
+ * @param readingHandle - Reading handle.
+ * @param data - Bytes to be set, can be NULL if length is 0.
+ * @param length - Length of data.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note See ezmqReadingSetDouble.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqReadingSetBytes(ezmqReadingHandle_t readingHandle, const uint8_t *data,
+        size_t length);
+
+/**
+ * Get type of value of given reading handle.
+ *
+ * @param readingHandle - Reading handle.
+ * @param type - Value type will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqReadingGetValueType(ezmqReadingHandle_t readingHandle, CEZMQValueType *type);
+
+/**
+ * Get typed double value of given reading handle.
+ *
+ * @param readingHandle - Reading handle.
+ * @param value - value will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, CEZMQ_ERROR if reading has no double value.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqReadingGetDouble(ezmqReadingHandle_t readingHandle, double *value);
+
+/**
+ * Get typed 64 bit integer value of given reading handle.
+ *
+ * @param readingHandle - Reading handle.
+ * @param value - value will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, CEZMQ_ERROR if reading has no integer value.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqReadingGetInt64(ezmqReadingHandle_t readingHandle, int64_t *value);
+
+/**
+ * Get typed boolean value of given reading handle.
+ *
+ * @param readingHandle - Reading handle.
+ * @param value - 1 for true or 0 will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, CEZMQ_ERROR if reading has no boolean value.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqReadingGetBool(ezmqReadingHandle_t readingHandle, int *value);
+
+/**
+ * Get typed byte array value of given reading handle.
+ * Note: Application should not free data, it is valid until reading is changed.
+ *
+ * @param readingHandle - Reading handle.
+ * @param data - Pointer to bytes will be filled as return value.
+ * @param length - Length of bytes will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, CEZMQ_ERROR if reading has no byte value.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqReadingGetBytes(ezmqReadingHandle_t readingHandle, const uint8_t **data,
+        size_t *length);
+
 #ifdef __cplusplus
 }
 #endif
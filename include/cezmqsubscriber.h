@@ -24,8 +24,12 @@
 #ifndef __EZMQ_SUB_H_INCLUDED__
 #define __EZMQ_SUB_H_INCLUDED__
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "cezmqerrorcodes.h"
 #include "cezmqevent.h"
+#include "cezmqtopic.h"
 
 #define EZMQ_EXPORT __attribute__ ((visibility("default")))
 
@@ -39,6 +43,21 @@ extern "C"
  */
 typedef void * ezmqSubHandle_t;
 
+/**
+ * Reactor handle, threads of reactor are shared by subscribers created with it.
+ */
+typedef void * ezmqReactorHandle_t;
+
+/**
+ * Max threads of a reactor.
+ */
+#define CEZMQ_REACTOR_MAX_THREADS 64
+
+/**
+ * Max dispatch threads of a subscriber.
+ */
+#define CEZMQ_MAX_DISPATCH_THREADS 64
+
 /**
  * Callbacks to get all the subscribed events.
  */
@@ -49,6 +68,51 @@ typedef void (*csubCB)(const ezmqMsgHandle_t event, CEZMQContentType contentType
  */
 typedef void (*csubTopicCB)(const char * topic, const ezmqMsgHandle_t event, CEZMQContentType contentType);
 
+/**
+ * Extended callback to get all the subscribed events. topic is NULL [topicLength 0] for event
+ * published without topic, size is length of byte data or serialized size of event.
+ */
+typedef void (*csubCBEx)(const char *topic, size_t topicLength, const ezmqMsgHandle_t event,
+        CEZMQContentType contentType, size_t size, void *userData);
+
+/**
+ * How received events are given to application.
+ */
+typedef enum
+{
+    CEZMQ_RECEIVE_CALLBACK = 0,     /**< Subscriber callbacks are called. */
+    CEZMQ_RECEIVE_PULL              /**< Application takes events using ezmqSubscriberReceive. */
+} CEZMQReceiveMode;
+
+/**
+ * Version of subscriber options structure known to this library.
+ */
+#define CEZMQ_SUB_OPTIONS_VERSION 4
+
+/**
+ * Subscriber options. Initialize using ezmqInitSubOptions before changing the fields so
+ * that fields added in later versions get their defaults. Options size the queue of this
+ * library behind EZMQ subscriber, no socket options are set.
+ */
+typedef struct
+{
+    int version;                    /**< Version of structure, set by ezmqInitSubOptions. */
+    int dispatchQueueSize;          /**< Max events waiting for callback, 0 calls back on EZMQ receiver thread. */
+    CEZMQReceiveMode receiveMode;   /**< Since version 2. Pull mode needs dispatchQueueSize > 0. */
+    ezmqReactorHandle_t reactor;    /**< Since version 3. Reactor running callbacks, NULL for own threads. */
+    int dispatchThreads;            /**< Since version 4. Threads calling callbacks, needs dispatchQueueSize > 0. */
+} CEZMQSubOptions;
+
+/**
+ * Event taken using ezmqSubscriberReceiveBatch.
+ */
+typedef struct
+{
+    char *topic;                    /**< Topic, NULL for event published without topic. */
+    ezmqMsgHandle_t event;          /**< Event [ezmqEventHandle_t or ezmqByteDataHandle_t]. */
+    CEZMQContentType contentType;   /**< Content type of event. */
+} CEZMQReceivedMessage;
+
 /**
  *  Create ezmq Subscriber with given ip, port and callbacks.
  *
@@ -63,6 +127,307 @@ typedef void (*csubTopicCB)(const char * topic, const ezmqMsgHandle_t event, CEZ
 EZMQ_EXPORT CEZMQErrorCode ezmqCreateSubscriber(const char *ip, int port, csubCB subcb,
         csubTopicCB topiccb, ezmqSubHandle_t *subHandle);
 
+/**
+ * Initialize subscriber options with default values.
+ *
+ * @param options - Options to be initialized.
+ * @param version - Version of options structure, CEZMQ_SUB_OPTIONS_VERSION of the header
+ *                  application is built with.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Version is set in options and only fields defined by that version are written, so a
+ *     structure of older version can be given. CEZMQ_ERROR is returned for unknown version.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqInitSubOptions(CEZMQSubOptions *options, int version);
+
+/**
+ *  Create ezmq Subscriber with given ip, port, options and callbacks.
+ *
+ * @param ip - IP to be used for Subscriber socket.
+ * @param port - Port to be used for Subscriber socket.
+ * @param options - Subscriber options.
+ * @param subcb - Callback to recieve events from socket.
+ * @param topiccb - Callback to recieve events from socket on a particular topic.
+ * @param subHandle  -Handle will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) With dispatchQueueSize > 0, received events are copied to a queue of dispatchQueueSize
+ *     events and callbacks are called from a dispatcher thread, so slow callbacks do not
+ *     stall EZMQ receiver. This adds a dispatcher thread per subscriber [unless it uses a
+ *     reactor]. Events received while queue is full are dropped
+ *     [See ezmqGetSubDroppedCount]. <br>
+ * (2) Event given to callback is valid only during the callback. <br>
+ * (3) No socket options are set. Socket level options of EZMQ subscriber [zmq HWM, buffers,
+ *     keepalive] are owned by EZMQ library. <br>
+ * (4) With dispatchThreads > 1, dispatchQueueSize is split over dispatch threads, each having
+ *     own queue of dispatchQueueSize / dispatchThreads events [rounded up]. Events are
+ *     assigned to threads by hash of topic, so events of a topic are given to callback in
+ *     order while different topics are handled in parallel. Events without topic go to the
+ *     first thread. Callbacks should be thread safe then. Not supported with pull mode or
+ *     reactor.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqCreateSubscriberEx(const char *ip, int port,
+        const CEZMQSubOptions *options, csubCB subcb, csubTopicCB topiccb, ezmqSubHandle_t *subHandle);
+
+/**
+ * Create ezmq subscriber connected to given endpoint.
+ *
+ * @param endpoint - Endpoint to subscribe on: "tcp://ip:port", "inproc://name" or "shm://name".
+ * @param options - Subscriber options, NULL for defaults.
+ * @param subcb - Subscriber callback.
+ * @param topiccb - Subscriber callback for topic based subscription.
+ * @param subHandle - Handle to be filled.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Subscriber on inproc endpoint receives events of publisher bound to the same name in this
+ *     process, it can be created before the publisher. <br>
+ * (2) Without dispatch queue, inproc events are given to callbacks on the publishing thread. <br>
+ * (3) Subscriber on shm endpoint reads events of same host publisher from shared memory ring.
+ *     Publisher should be started before the subscriber, otherwise emzqStartSubscriber returns
+ *     CEZMQ_ERROR. Events published after start are received, by a reader thread. Events
+ *     overwritten before being read are counted by ezmqGetSubGapCount. <br>
+ * (4) ipc endpoints are not supported by EZMQ library, CEZMQ_ERROR is returned for them. <br>
+ * (5) ezmqSubscribeWithIpPort, key setters, ezmqGetSubIp and ezmqGetSubPort return CEZMQ_ERROR
+ *     for subscriber on inproc or shm endpoint.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqCreateSubscriberWithEndpoint(const char *endpoint,
+        const CEZMQSubOptions *options, csubCB subcb, csubTopicCB topiccb, ezmqSubHandle_t *subHandle);
+
+/**
+ * Create reactor with given number of threads. Subscribers created with the reactor in their
+ * options share its threads instead of having own dispatcher and shm reader threads. Each tcp
+ * subscriber still has its own EZMQ socket and EZMQ receiver thread, so a reactor bounds only
+ * the threads added by this library.
+ *
+ * @param threadCount - Number of threads [1 to CEZMQ_REACTOR_MAX_THREADS].
+ * @param reactorHandle - Handle will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Started subscriber is assigned to the reactor thread having least subscribers, all its
+ *     callbacks are called on that thread, in order. Subscribers keep own callbacks and topics. <br>
+ * (2) Reactor threads call callbacks for events of dispatch queue and read shm rings, so
+ *     creating tcp or inproc subscriber with reactor and dispatchQueueSize 0 returns
+ *     CEZMQ_ERROR. <br>
+ * (3) A slow callback delays other subscribers of the same thread. <br>
+ * (4) Subscriber on a reactor can be stopped or started from its own callback, but should
+ *     not be destroyed from it. <br>
+ * (5) Sockets and receiver threads of EZMQ subscribers are owned by EZMQ library and are
+ *     not shared.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqCreateReactor(int threadCount, ezmqReactorHandle_t *reactorHandle);
+
+/**
+ * Destroy reactor, its threads are stopped.
+ *
+ * @param reactorHandle - Reactor handle.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) CEZMQ_ERROR is returned if subscribers created with the reactor are not destroyed.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqDestroyReactor(ezmqReactorHandle_t *reactorHandle);
+
+/**
+ * Get effective options of given subscriber.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param options - Options will be filled as return value [initialized by ezmqInitSubOptions].
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) dispatchQueueSize is rounded up to power of two, per dispatch thread when there are more
+ *     than one, and is given as total of their queues.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqGetSubOptions(ezmqSubHandle_t subHandle, CEZMQSubOptions *options);
+
+/**
+ * Get number of received events dropped as dispatch queue was full.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param count - Dropped count will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqGetSubDroppedCount(ezmqSubHandle_t subHandle, uint64_t *count);
+
+/**
+ * Take next received event of subscriber created in pull mode, on calling thread.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param timeout - Time [in milliseconds] to wait for event, 0 does not wait and -1 waits
+ *                  till event is received or subscriber is stopped.
+ * @param topic - Topic will be filled as return value, NULL for event published without topic.
+ * @param event - Event will be filled as return value.
+ * @param contentType - Content type of event will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, CEZMQ_TIMEOUT if no event is received in time,
+ *                          otherwise appropriate error code.
+ *
+ * @note
+ * (1) Subscriber should be created using options with receiveMode CEZMQ_RECEIVE_PULL,
+ *     subscriber callbacks are then not called and can be NULL. <br>
+ * (2) Topic and event are owned by application and should be released using
+ *     ezmqReleaseMessage before subscriber is destroyed. <br>
+ * (3) CEZMQ_ERROR is returned if subscriber is not started, or is stopped while waiting.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqSubscriberReceive(ezmqSubHandle_t subHandle, int timeout, char **topic,
+        ezmqMsgHandle_t *event, CEZMQContentType *contentType);
+
+/**
+ * Get file descriptor of subscriber created in pull mode, for use with poll/epoll based
+ * event loops. It is readable while received events are pending.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param fd - File descriptor will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) When fd is readable, take events using ezmqSubscriberReceive or ezmqSubscriberReceiveBatch
+ *     with timeout 0 till CEZMQ_TIMEOUT is returned. Fd is made non-readable then, it should
+ *     not be read by application. <br>
+ * (2) Fd is owned by subscriber and closed by ezmqDestroySubscriber. <br>
+ * (3) Receiver threads of EZMQ library itself are not affected, fd only removes the need
+ *     for an application thread per subscriber.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqGetSubscriberFd(ezmqSubHandle_t subHandle, int *fd);
+
+/**
+ * Take up to maxCount received events of subscriber created in pull mode.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param timeout - Time [in milliseconds] to wait for first event, same as ezmqSubscriberReceive.
+ * @param messages - Array of maxCount entries, filled with received events.
+ * @param maxCount - Max number of events to be taken.
+ * @param count - Number of events taken will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, CEZMQ_TIMEOUT if no event is received in time,
+ *                          otherwise appropriate error code.
+ *
+ * @note
+ * (1) Waits only for the first event, then takes events already in dispatch queue. <br>
+ * (2) Taken events should be released using ezmqReleaseMessages before subscriber is destroyed.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqSubscriberReceiveBatch(ezmqSubHandle_t subHandle, int timeout,
+        CEZMQReceivedMessage *messages, int maxCount, int *count);
+
+/**
+ * Keep event given to subscriber callback beyond the callback. Retained event can be used
+ * on any thread till it is released using ezmqReleaseMessage with the same subscriber.
+ *
+ * @param subHandle - Subscriber handle which gave the event.
+ * @param event - Event given to callback.
+ * @param retained - Retained event will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, CEZMQ_QUEUE_FULL if retain budget of subscriber
+ *                          would be exceeded, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Event given by dispatcher or reactor thread [dispatchQueueSize > 0] is retained without
+ *     copy and retained is same as event. Event given on EZMQ receiver or publishing thread
+ *     is owned by EZMQ and is copied. <br>
+ * (2) Retaining a retained event or an event taken using ezmqSubscriberReceive increments its
+ *     reference count, each retain needs a release. <br>
+ * (3) Size of retained events is counted in budget of subscriber [See ezmqSetSubRetainBudget]. <br>
+ * (4) Events are decoded by EZMQ library, their zmq message buffers are not kept. <br>
+ * (5) Events not released are freed by ezmqDestroySubscriber.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqRetainMessage(ezmqSubHandle_t subHandle, const ezmqMsgHandle_t event,
+        ezmqMsgHandle_t *retained);
+
+/**
+ * Set max bytes of events retained from subscriber at a time.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param bytes - Max bytes [size of byte data or serialized size of event], 0 for no limit.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqSetSubRetainBudget(ezmqSubHandle_t subHandle, size_t bytes);
+
+/**
+ * Get bytes of events retained from subscriber and not yet released.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param bytes - Retained bytes will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqGetSubRetainedSize(ezmqSubHandle_t subHandle, size_t *bytes);
+
+/**
+ * Release topic and event taken using ezmqSubscriberReceive, or event retained using
+ * ezmqRetainMessage.
+ *
+ * @param subHandle - Subscriber handle which gave the event.
+ * @param topic - Topic to be released, it will be set to NULL. NULL for retained event.
+ * @param event - Event to be released, it will be set to NULL.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) CEZMQ_ERROR is returned for event which was not taken from or retained using the
+ *     subscriber, such event is not freed. <br>
+ * (2) Events should be released before subscriber is destroyed.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqReleaseMessage(ezmqSubHandle_t subHandle, char **topic,
+        ezmqMsgHandle_t *event);
+
+/**
+ * Release events taken using ezmqSubscriberReceiveBatch.
+ *
+ * @param subHandle - Subscriber handle which gave the events.
+ * @param messages - Events to be released.
+ * @param count - Number of events.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) CEZMQ_ERROR is returned if any event was not taken from the subscriber, other events
+ *     are released.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqReleaseMessages(ezmqSubHandle_t subHandle, CEZMQReceivedMessage *messages,
+        int count);
+
+/**
+ * Get number of events missed by subscriber on shm endpoint, as they were overwritten
+ * by publisher before being read.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param count - Missed events count will be filled as return value, 0 for other endpoints.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqGetSubGapCount(ezmqSubHandle_t subHandle, uint64_t *count);
+
+/**
+ * Set extended callback, it is called for all the events instead of subscriber callbacks.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param callback - Extended callback.
+ * @param userData - User data passed to callback.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) This API should be called before emzqStartSubscriber API. <br>
+ * (2) For shm endpoint without dispatch queue, nothing is allocated from reading an event to
+ *     calling the callback, once buffers reused for parsing are warmed up. Events of tcp
+ *     endpoint are decoded and allocated by EZMQ library before this library gets them.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqSetSubscriberCallbackEx(ezmqSubHandle_t subHandle, csubCBEx callback,
+        void *userData);
+
 /**
  * Set the security keys of client/its own.
  *
@@ -131,6 +496,64 @@ EZMQ_EXPORT CEZMQErrorCode  ezmqSubscribe(ezmqSubHandle_t subHandle);
  */
 EZMQ_EXPORT CEZMQErrorCode ezmqSubscribeForTopic(ezmqSubHandle_t subHandle, const char *topic);
 
+/**
+ * Subscribe for events on a particular topic, given to callback of the topic.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param topic - Topic to be subscribed.
+ * @param callback - Callback for events of the topic.
+ * @param userData - User data passed to callback.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Topics are kept in a prefix trie, event is routed in O(topic length) to callback of
+ *     the longest subscribed topic it matches. Events matching no such topic are given to
+ *     subscriber callbacks. <br>
+ * (2) Subscribing the topic again replaces its callback, previous callback is kept if
+ *     subscribe fails. Topic un-subscribe APIs remove the callback along with the last
+ *     subscription of the topic. <br>
+ * (3) Callback may still be called for events being dispatched while topic is un-subscribed.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqSubscribeForTopicWithCallback(ezmqSubHandle_t subHandle,
+        const char *topic, csubCBEx callback, void *userData);
+
+/**
+ * Subscribe for events of topics matching a wildcard pattern.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param pattern - Topic pattern, for example: area/1/#
+ * @param callback - Callback for events matching the pattern, NULL to give them to
+ *                   subscriber callbacks.
+ * @param userData - User data passed to callback.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Level "*" matches any one topic level and "#", allowed only as last level, matches
+ *     any number of levels including none. Other levels are same as topic name. <br>
+ * (2) Topic levels before the first wildcard are subscribed as prefix, events under the
+ *     prefix which match no pattern and no subscribed topic are dropped before dispatch
+ *     [before parsing for shared memory events]. <br>
+ * (3) Patterns are compiled into a trie of levels, matching cost depends on topic levels
+ *     and not on number of patterns. Callbacks of ezmqSubscribeForTopicWithCallback are
+ *     looked up first, then literal levels are preferred over "*" and "*" over "#". <br>
+ * (4) Subscribing the pattern again replaces its callback.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqSubscribeForTopicPattern(ezmqSubHandle_t subHandle,
+        const char *pattern, csubCBEx callback, void *userData);
+
+/**
+ * Subscribe for event/messages on the topic of given topic handle.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param topicHandle - Topic handle created using ezmqCreateTopic.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqSubscribeForTopicHandle(ezmqSubHandle_t subHandle,
+        ezmqTopicHandle_t topicHandle);
+
 /**
  * Subscribe for event/messages on given list of topics. On any of the topic
  * in list, if it failed to subscribe events it will return
@@ -149,6 +572,17 @@ EZMQ_EXPORT CEZMQErrorCode ezmqSubscribeForTopic(ezmqSubHandle_t subHandle, cons
 EZMQ_EXPORT CEZMQErrorCode ezmqSubscribeForTopicList(ezmqSubHandle_t subHandle,
         const char ** topicList, int listSize);
 
+/**
+ * Subscribe for event/messages on all the topics of given topic set.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param topicSet - Topic set handle created using ezmqCreateTopicSet.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqSubscribeForTopicSet(ezmqSubHandle_t subHandle,
+        ezmqTopicSetHandle_t topicSet);
+
 /**
  * Subscribe for event/messages from given IP:Port on the given topic.
  *
@@ -193,6 +627,17 @@ EZMQ_EXPORT CEZMQErrorCode ezmqUnSubscribe(ezmqSubHandle_t subHandle);
  */
 EZMQ_EXPORT CEZMQErrorCode ezmqUnSubscribeForTopic(ezmqSubHandle_t subHandle, const char *topic);
 
+/**
+ * Un-subscribe events of the topic of given topic handle.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param topicHandle - Topic handle created using ezmqCreateTopic.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqUnSubscribeForTopicHandle(ezmqSubHandle_t subHandle,
+        ezmqTopicHandle_t topicHandle);
+
 /**
  * Un-subscribe event/messages on given list of topics. On any of the topic
  * in list, if it failed to unsubscribe events it will return
@@ -211,6 +656,29 @@ EZMQ_EXPORT CEZMQErrorCode ezmqUnSubscribeForTopic(ezmqSubHandle_t subHandle, co
 EZMQ_EXPORT CEZMQErrorCode ezmqUnSubscribeForTopicList(ezmqSubHandle_t subHandle, const char ** topicList,
         int listSize);
 
+/**
+ * Un-subscribe events of all the topics of given topic set.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param topicSet - Topic set handle created using ezmqCreateTopicSet.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqUnSubscribeForTopicSet(ezmqSubHandle_t subHandle,
+        ezmqTopicSetHandle_t topicSet);
+
+/**
+ * Un-subscribe a pattern subscribed using ezmqSubscribeForTopicPattern.
+ *
+ * @param subHandle - Subscriber handle.
+ * @param pattern - Topic pattern to be un-subscribed.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, CEZMQ_INVALID_TOPIC if pattern is not
+ *         subscribed, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqUnSubscribeForTopicPattern(ezmqSubHandle_t subHandle,
+        const char *pattern);
+
 /**
  * Stops SUB instance.
  *
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+
+/**
+ * @file   cezmqtopic.h
+ *
+ * @brief This file provides APIs for precompiled topic handles.
+ */
+
+#ifndef __EZMQ_TOPIC_H_INCLUDED__
+#define __EZMQ_TOPIC_H_INCLUDED__
+
+#include "cezmqerrorcodes.h"
+
+#define EZMQ_EXPORT __attribute__ ((visibility("default")))
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Topic handle
+ */
+typedef void * ezmqTopicHandle_t;
+
+/**
+ * Topic set handle
+ */
+typedef void * ezmqTopicSetHandle_t;
+
+/**
+ * Create topic handle. Topic is validated and interned once, so that it can be used
+ * for publishing/subscribing without validating and copying it again.
+ *
+ * @param topic - Topic name.
+ * @param topicHandle - Topic handle will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Topic name should be as path format. For example: home/livingroom/  <br>
+ * (2) Topic name can have letters [a-z, A-z], numerics [0-9] and special characters _ - . and / <br>
+ * (3) Handles created for same topic name share same interned topic.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqCreateTopic(const char *topic, ezmqTopicHandle_t *topicHandle);
+
+/**
+ * Get topic name of given topic handle.
+ * Note: Application should not free topic.
+ *
+ * @param topicHandle - Topic handle.
+ * @param topic - Topic name will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqGetTopicName(ezmqTopicHandle_t topicHandle, char **topic);
+
+/**
+ * Destroy topic handle. Application needs to call this API once for every
+ * ezmqCreateTopic call.
+ *
+ * @param topicHandle - Topic handle.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqDestroyTopic(ezmqTopicHandle_t *topicHandle);
+
+/**
+ * Create topic set from the given list of topics. Topics are validated once and
+ * kept in the form used by EZMQ, so that publishing same event on many topics does
+ * not need to build the topic list for every event.
+ *
+ * @param topicList - List of topics.
+ * @param listSize - Size of topicList.
+ * @param topicSet - Topic set handle will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ *
+ * @note
+ * (1) Topic name should be as path format. For example: home/livingroom/  <br>
+ * (2) Topic name can have letters [a-z, A-z], numerics [0-9] and special characters _ - . and /
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqCreateTopicSet(const char **topicList, int listSize,
+        ezmqTopicSetHandle_t *topicSet);
+
+/**
+ * Get number of topics in the given topic set.
+ *
+ * @param topicSet - Topic set handle.
+ * @param size - Number of topics will be filled as return value.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqGetTopicSetSize(ezmqTopicSetHandle_t topicSet, int *size);
+
+/**
+ * Destroy topic set.
+ *
+ * @param topicSet - Topic set handle.
+ *
+ * @return CEZMQErrorCode - CEZMQ_OK on success, otherwise appropriate error code.
+ */
+EZMQ_EXPORT CEZMQErrorCode ezmqDestroyTopicSet(ezmqTopicSetHandle_t *topicSet);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__EZMQ_TOPIC_H_INCLUDED__
@@ -50,16 +50,12 @@ void errorCB(CEZMQErrorCode code)
 
 ezmqEventHandle_t createEvent()
 {
-    const char *id = "id";
-    const char *device = "device";
-    const char *readingId1 = "id1";
-    const char *readingName1 = "reading1";
-    const char *readingValue1 = "25";
-    const char *readingDevice1 = "device";
-    const char *readingId2 = "id2";
-    const char *readingName2 = "reading2";
-    const char *readingValue2 = "20";
-    const char *readingDevice2 = "device";
+    CEZMQEventFields fields = {"id", 10, 20, 20, 10, "device"};
+    CEZMQReadingFields readings[2] =
+    {
+        {"id1", 25, 20, 25, 1, "reading1", "25", "device"},
+        {"id2", 30, 20, 25, 1, "reading2", "20", "device"}
+    };
 
     ezmqEventHandle_t eventHandle; //creation and set event fields
     CEZMQErrorCode  result = ezmqCreateEvent(&eventHandle);
@@ -68,34 +64,10 @@ ezmqEventHandle_t createEvent()
         printf("\nEvent initialization [Result]: %d\n", result);
         return NULL;
     }
-    ezmqEventSetID(eventHandle, id);
-    ezmqEventSetCreated(eventHandle, 10);
-    ezmqEventSetModified(eventHandle, 20);
-    ezmqEventSetOrigin(eventHandle, 20);
-    ezmqEventSetPushed(eventHandle, 10);
-    ezmqEventSetDevice(eventHandle, device);
-
-     ezmqReadingHandle_t reading1Handle; //creation and set first reading fields
-    ezmqCreateReading(eventHandle, &reading1Handle);
-    ezmqReadingSetID(reading1Handle, readingId1 );
-    ezmqReadingSetCreated(reading1Handle, 25);
-    ezmqReadingSetModified(reading1Handle, 20);
-    ezmqReadingSetOrigin(reading1Handle, 25);
-    ezmqReadingSetPushed(reading1Handle, 1);
-    ezmqReadingSetName(reading1Handle, readingName1);
-    ezmqReadingSetValue(reading1Handle, readingValue1);
-    ezmqReadingSetDevice(reading1Handle, readingDevice1);
+    ezmqEventSetAll(eventHandle, &fields);
 
-    ezmqReadingHandle_t reading2Handle; //creation and set second reading fields
-    ezmqCreateReading(eventHandle, &reading2Handle);
-    ezmqReadingSetID(reading2Handle, readingId2);
-    ezmqReadingSetCreated(reading2Handle, 30);
-    ezmqReadingSetModified(reading2Handle, 20);
-    ezmqReadingSetOrigin(reading2Handle, 25);
-    ezmqReadingSetPushed(reading2Handle, 1);
-    ezmqReadingSetName(reading2Handle, readingName2);
-    ezmqReadingSetValue(reading2Handle, readingValue2);
-    ezmqReadingSetDevice(reading2Handle, readingDevice2);
+    //creation and set reading fields
+    ezmqEventAddReadings(eventHandle, readings, 2);
 
     return eventHandle;
 }
@@ -15,12 +15,164 @@
  *
  *******************************************************************************/
 #include <iostream>
+#include <cstring>
+#include <arpa/inet.h>
 
 #include "cezmqbytedata.h"
+#include "cezmqinternal.h"
 #include "EZMQByteData.h"
 
+// Segmented byte data: segment count and length of each segment [32 bit, network byte
+// order], followed by the segments back to back.
+#define SEGMENT_FIELD_SIZE 4
+
 using namespace ezmq;
 
+byteDataRef::byteDataRef(uint8_t *data, size_t dataLength, ezmqByteDataFreeCB freeFn, void *hint)
+    : EZMQByteData(data, 0), mRef(data), mRefLength(dataLength), mFreeFn(freeFn), mHint(hint),
+      mReaders(0)
+{
+}
+
+byteDataRef::~byteDataRef()
+{
+    uint8_t *ref = mRef.load();
+    if (ref)
+    {
+        mFreeFn(ref, mHint);
+    }
+}
+
+const uint8_t *byteDataRef::data() const
+{
+    const uint8_t *ref = mRef.load();
+    return ref ? ref : getByteData();
+}
+
+size_t byteDataRef::length() const
+{
+    // Copy taken on detach has same length.
+    return mRefLength;
+}
+
+void byteDataRef::detach()
+{
+    // Concurrent publishers of same byte data wait here till the copy is taken.
+    std::call_once(mDetached, [this]()
+    {
+        uint8_t *ref = mRef.load();
+        setByteData(ref, mRefLength);
+        // Readers pinning from now on get the copy, buffer is freed once earlier ones unpin.
+        mRef.store(NULL);
+        {
+            std::unique_lock<std::mutex> lock(mLock);
+            while (mReaders.load() > 0)
+            {
+                mUnpinned.wait(lock);
+            }
+        }
+        mFreeFn(ref, mHint);
+    });
+}
+
+const uint8_t *byteDataRef::pin() const
+{
+    mReaders.fetch_add(1);
+    return data();
+}
+
+void byteDataRef::unpin() const
+{
+    // Last reader wakes detach only once it has started, so unpin is lock-free before that.
+    if (1 == mReaders.fetch_sub(1) && !mRef.load())
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mUnpinned.notify_all();
+    }
+}
+
+byteDataView::byteDataView(const EZMQByteData *byteData)
+    : mRef(dynamic_cast<const byteDataRef *>(byteData))
+{
+    mData = mRef ? mRef->pin() : byteData->getByteData();
+}
+
+byteDataView::~byteDataView()
+{
+    if (mRef)
+    {
+        mRef->unpin();
+    }
+}
+
+const uint8_t *ezmq::getByteDataPtr(const EZMQByteData *byteData)
+{
+    const byteDataRef *ref = dynamic_cast<const byteDataRef *>(byteData);
+    return ref ? ref->data() : byteData->getByteData();
+}
+
+size_t ezmq::getByteDataLength(const EZMQByteData *byteData)
+{
+    const byteDataRef *ref = dynamic_cast<const byteDataRef *>(byteData);
+    return ref ? ref->length() : byteData->getLength();
+}
+
+void ezmq::detachByteData(const EZMQByteData *byteData)
+{
+    // Handles given to C APIs are not const, so casting away const here is safe.
+    byteDataRef *ref = dynamic_cast<byteDataRef *>(const_cast<EZMQByteData *>(byteData));
+    if (ref)
+    {
+        ref->detach();
+    }
+}
+
+size_t ezmq::getSegmentedLength(const struct iovec *iov, int iovcnt)
+{
+    size_t length = SEGMENT_FIELD_SIZE * (1 + (size_t) iovcnt);
+    for (int i = 0; i < iovcnt; i++)
+    {
+        if (iov[i].iov_len > UINT32_MAX || (!iov[i].iov_base && iov[i].iov_len))
+        {
+            return 0;
+        }
+        length += iov[i].iov_len;
+    }
+    return length;
+}
+
+static void writeSegmentField(uint8_t *data, size_t value)
+{
+    uint32_t field = htonl((uint32_t) value);
+    memcpy(data, &field, SEGMENT_FIELD_SIZE);
+}
+
+static size_t readSegmentField(const uint8_t *data)
+{
+    uint32_t field;
+    memcpy(&field, data, SEGMENT_FIELD_SIZE);
+    return ntohl(field);
+}
+
+void ezmq::writeSegments(uint8_t *data, const struct iovec *iov, int iovcnt)
+{
+    writeSegmentField(data, iovcnt);
+    data += SEGMENT_FIELD_SIZE;
+    for (int i = 0; i < iovcnt; i++)
+    {
+        writeSegmentField(data, iov[i].iov_len);
+        data += SEGMENT_FIELD_SIZE;
+    }
+    for (int i = 0; i < iovcnt; i++)
+    {
+        if (iov[i].iov_len)
+        {
+            memcpy(data, iov[i].iov_base, iov[i].iov_len);
+            data += iov[i].iov_len;
+        }
+    }
+}
+
 CEZMQErrorCode ezmqCreateByteData(ezmqByteDataHandle_t *dataHandle, uint8_t * data, size_t dataLength)
 {
     VERIFY_NON_NULL(dataHandle)
@@ -30,11 +182,23 @@ CEZMQErrorCode ezmqCreateByteData(ezmqByteDataHandle_t *dataHandle, uint8_t * da
     return CEZMQ_OK;
 }
 
+CEZMQErrorCode ezmqCreateLocalByteDataNoCopy(ezmqByteDataHandle_t *dataHandle, uint8_t *data,
+        size_t dataLength, ezmqByteDataFreeCB freeFn, void *hint)
+{
+    VERIFY_NON_NULL(dataHandle)
+    VERIFY_NON_NULL(data)
+    VERIFY_NON_NULL(freeFn)
+    *dataHandle = static_cast<EZMQByteData *>(new(std::nothrow) byteDataRef(data, dataLength,
+            freeFn, hint));
+    ALLOC_ASSERT(*dataHandle)
+    return CEZMQ_OK;
+}
+
 CEZMQErrorCode ezmqGetByteData(ezmqByteDataHandle_t dataHandle, uint8_t ** data)
 {
     VERIFY_NON_NULL(dataHandle)
     VERIFY_NON_NULL(data)
-    *data = (uint8_t *)static_cast<ezmq::EZMQByteData*>(dataHandle)->getByteData();
+    *data = (uint8_t *)getByteDataPtr(static_cast<ezmq::EZMQByteData*>(dataHandle));
     return CEZMQ_OK;
 }
 
@@ -42,7 +206,55 @@ CEZMQErrorCode ezmqGetDataLength(ezmqByteDataHandle_t dataHandle, size_t *dataLe
 {
     VERIFY_NON_NULL(dataHandle)
     VERIFY_NON_NULL(dataLength)
-    *dataLength = static_cast<ezmq::EZMQByteData *>(dataHandle)->getLength();
+    *dataLength = getByteDataLength(static_cast<ezmq::EZMQByteData *>(dataHandle));
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqGetByteDataSegments(ezmqByteDataHandle_t dataHandle, struct iovec *segments,
+        int *count)
+{
+    VERIFY_NON_NULL(dataHandle)
+    VERIFY_NON_NULL(count)
+    const EZMQByteData *byteData = static_cast<const EZMQByteData *>(dataHandle);
+    const uint8_t *data = getByteDataPtr(byteData);
+    size_t length = getByteDataLength(byteData);
+    if (length < SEGMENT_FIELD_SIZE)
+    {
+        return CEZMQ_ERROR;
+    }
+    size_t segmentCount = readSegmentField(data);
+    if (segmentCount > INT32_MAX || (length / SEGMENT_FIELD_SIZE) - 1 < segmentCount)
+    {
+        return CEZMQ_ERROR;
+    }
+
+    // Lengths should add up to the data which follows them.
+    size_t offset = SEGMENT_FIELD_SIZE * (1 + segmentCount);
+    size_t total = offset;
+    for (size_t i = 0; i < segmentCount; i++)
+    {
+        total += readSegmentField(data + SEGMENT_FIELD_SIZE * (1 + i));
+        if (total > length)
+        {
+            return CEZMQ_ERROR;
+        }
+    }
+    if (total != length)
+    {
+        return CEZMQ_ERROR;
+    }
+    if (!segments || *count < (int) segmentCount)
+    {
+        *count = segmentCount;
+        return CEZMQ_ERROR;
+    }
+    for (size_t i = 0; i < segmentCount; i++)
+    {
+        segments[i].iov_len = readSegmentField(data + SEGMENT_FIELD_SIZE * (1 + i));
+        segments[i].iov_base = (void *) (data + offset);
+        offset += segments[i].iov_len;
+    }
+    *count = segmentCount;
     return CEZMQ_OK;
 }
 
@@ -15,11 +15,32 @@
  *
  *******************************************************************************/
 
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include <google/protobuf/arena.h>
+
 #include "cezmqevent.h"
 #include "Event.pb.h"
 
 using namespace ezmq;
 
+// Released events, kept cleared for reuse.
+typedef struct eventPool
+{
+    std::mutex lock;
+    std::vector<ezmq::Event *> events;
+    size_t size;
+} eventPool;
+
+// Arena with first block owned by cezmq, arena keeps only this block on reset.
+typedef struct eventArena
+{
+    google::protobuf::Arena *arena;
+    char *block;
+} eventArena;
+
 CEZMQErrorCode ezmqEventGetID(ezmqEventHandle_t eventHandle, char **value)
 {
     VERIFY_NON_NULL(eventHandle)
@@ -91,6 +112,88 @@ CEZMQErrorCode ezmqEventGetReading(ezmqEventHandle_t eventHandle, int index, voi
     return CEZMQ_OK;
 }
 
+CEZMQErrorCode ezmqEventGetReadings(ezmqEventHandle_t eventHandle, CEZMQReadingView *out,
+        int capacity, int *count)
+{
+    VERIFY_NON_NULL(eventHandle)
+    VERIFY_NON_NULL(count)
+    if (capacity < 0 || (capacity > 0 && !out))
+    {
+        return CEZMQ_ERROR;
+    }
+    const ezmq::Event *event = static_cast<ezmq::Event *>(eventHandle);
+    *count = event->reading_size();
+    int filled = std::min(capacity, *count);
+    for (int i = 0; i < filled; i++)
+    {
+        const ezmq::Reading &reading = event->reading(i);
+        CEZMQReadingView &view = out[i];
+        view.id = reading.id().data();
+        view.idLength = reading.id().size();
+        view.created = reading.created();
+        view.modified = reading.modified();
+        view.origin = reading.origin();
+        view.pushed = reading.pushed();
+        view.name = reading.name().data();
+        view.nameLength = reading.name().size();
+        view.value = reading.value().data();
+        view.valueLength = reading.value().size();
+        view.device = reading.device().data();
+        view.deviceLength = reading.device().size();
+    }
+    return CEZMQ_OK;
+}
+
+// Column arrays not given by application are skipped.
+static inline void getColumn(const std::string &field, int index, const char **strings, size_t *lengths)
+{
+    if (strings)
+    {
+        strings[index] = field.data();
+    }
+    if (lengths)
+    {
+        lengths[index] = field.size();
+    }
+}
+
+static inline void getColumn(long field, int index, long *values)
+{
+    if (values)
+    {
+        values[index] = field;
+    }
+}
+
+CEZMQErrorCode ezmqEventGetReadingColumns(ezmqEventHandle_t eventHandle,
+        const CEZMQReadingColumns *columns, int *count)
+{
+    VERIFY_NON_NULL(eventHandle)
+    VERIFY_NON_NULL(columns)
+    VERIFY_NON_NULL(count)
+    if (columns->capacity < 0)
+    {
+        return CEZMQ_ERROR;
+    }
+    const google::protobuf::RepeatedPtrField<ezmq::Reading> &readings =
+            static_cast<ezmq::Event *>(eventHandle)->reading();
+    *count = readings.size();
+    int filled = std::min(columns->capacity, *count);
+    for (int i = 0; i < filled; i++)
+    {
+        const ezmq::Reading &reading = readings.Get(i);
+        getColumn(reading.id(), i, columns->ids, columns->idLengths);
+        getColumn(reading.name(), i, columns->names, columns->nameLengths);
+        getColumn(reading.value(), i, columns->values, columns->valueLengths);
+        getColumn(reading.device(), i, columns->devices, columns->deviceLengths);
+        getColumn(reading.created(), i, columns->created);
+        getColumn(reading.modified(), i, columns->modified);
+        getColumn(reading.origin(), i, columns->origin);
+        getColumn(reading.pushed(), i, columns->pushed);
+    }
+    return CEZMQ_OK;
+}
+
 CEZMQErrorCode ezmqCreateEvent(ezmqEventHandle_t*eventHandle)
 {
     VERIFY_NON_NULL(eventHandle)
@@ -104,6 +207,10 @@ CEZMQErrorCode ezmqDestroyEvent(ezmqEventHandle_t *eventHandle)
     VERIFY_NON_NULL(eventHandle)
     VERIFY_NON_NULL(*eventHandle)
     ezmq::Event *event = static_cast<ezmq::Event *>(*eventHandle);
+    if (event->GetArena())
+    {
+        return CEZMQ_ERROR;
+    }
     delete event;
     *eventHandle = NULL;
     return CEZMQ_OK;
@@ -153,3 +260,179 @@ CEZMQErrorCode ezmqEventSetDevice(ezmqEventHandle_t eventHandle, const char *val
     return CEZMQ_OK;
 }
 
+// NULL string field of C structures sets empty value.
+static inline const char *getString(const char *value)
+{
+    return value ? value : "";
+}
+
+CEZMQErrorCode ezmqEventSetAll(ezmqEventHandle_t eventHandle, const CEZMQEventFields *fields)
+{
+    VERIFY_NON_NULL(eventHandle)
+    VERIFY_NON_NULL(fields)
+    ezmq::Event *event = static_cast<ezmq::Event *>(eventHandle);
+    event->set_id(getString(fields->id));
+    event->set_created(fields->created);
+    event->set_modified(fields->modified);
+    event->set_origin(fields->origin);
+    event->set_pushed(fields->pushed);
+    event->set_device(getString(fields->device));
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqEventAddReadings(ezmqEventHandle_t eventHandle, const CEZMQReadingFields *readings,
+        int count)
+{
+    VERIFY_NON_NULL(eventHandle)
+    VERIFY_NON_NULL(readings)
+    if (count < 0)
+    {
+        return CEZMQ_ERROR;
+    }
+    ezmq::Event *event = static_cast<ezmq::Event *>(eventHandle);
+    google::protobuf::RepeatedPtrField<ezmq::Reading> *added = event->mutable_reading();
+    added->Reserve(added->size() + count);
+    for (int i = 0; i < count; i++)
+    {
+        const CEZMQReadingFields &fields = readings[i];
+        ezmq::Reading *reading = added->Add();
+        reading->set_id(getString(fields.id));
+        reading->set_created(fields.created);
+        reading->set_modified(fields.modified);
+        reading->set_origin(fields.origin);
+        reading->set_pushed(fields.pushed);
+        reading->set_name(getString(fields.name));
+        reading->set_value(getString(fields.value));
+        reading->set_device(getString(fields.device));
+    }
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqCreateEventPool(int size, ezmqEventPoolHandle_t *poolHandle)
+{
+    VERIFY_NON_NULL(poolHandle)
+    if (size <= 0)
+    {
+        return CEZMQ_ERROR;
+    }
+    eventPool *pool = new(std::nothrow) eventPool();
+    ALLOC_ASSERT(pool)
+    pool->size = size;
+    pool->events.reserve(size);
+    for (int i = 0; i < size; i++)
+    {
+        ezmq::Event *event = new(std::nothrow) Event();
+        ALLOC_ASSERT(event)
+        pool->events.push_back(event);
+    }
+    *poolHandle = pool;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqDestroyEventPool(ezmqEventPoolHandle_t *poolHandle)
+{
+    VERIFY_NON_NULL(poolHandle)
+    VERIFY_NON_NULL(*poolHandle)
+    eventPool *pool = static_cast<eventPool *>(*poolHandle);
+    for (size_t i = 0; i < pool->events.size(); i++)
+    {
+        delete pool->events[i];
+    }
+    delete pool;
+    *poolHandle = NULL;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqEventPoolAcquire(ezmqEventPoolHandle_t poolHandle, ezmqEventHandle_t *eventHandle)
+{
+    VERIFY_NON_NULL(poolHandle)
+    VERIFY_NON_NULL(eventHandle)
+    eventPool *pool = static_cast<eventPool *>(poolHandle);
+    {
+        std::lock_guard<std::mutex> lock(pool->lock);
+        if (!pool->events.empty())
+        {
+            *eventHandle = pool->events.back();
+            pool->events.pop_back();
+            return CEZMQ_OK;
+        }
+    }
+    *eventHandle = new(std::nothrow) Event();
+    ALLOC_ASSERT(*eventHandle)
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqEventPoolRelease(ezmqEventPoolHandle_t poolHandle, ezmqEventHandle_t *eventHandle)
+{
+    VERIFY_NON_NULL(poolHandle)
+    VERIFY_NON_NULL(eventHandle)
+    VERIFY_NON_NULL(*eventHandle)
+    eventPool *pool = static_cast<eventPool *>(poolHandle);
+    ezmq::Event *event = static_cast<ezmq::Event *>(*eventHandle);
+    if (event->GetArena())
+    {
+        return CEZMQ_ERROR;
+    }
+    *eventHandle = NULL;
+    // Clear keeps cleared readings and string buffers for reuse by add_reading and setters.
+    event->Clear();
+    {
+        std::lock_guard<std::mutex> lock(pool->lock);
+        if (pool->events.size() < pool->size)
+        {
+            pool->events.push_back(event);
+            return CEZMQ_OK;
+        }
+    }
+    delete event;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqCreateArena(size_t blockSize, ezmqArenaHandle_t *arenaHandle)
+{
+    VERIFY_NON_NULL(arenaHandle)
+    eventArena *arenaObj = new(std::nothrow) eventArena();
+    ALLOC_ASSERT(arenaObj)
+    arenaObj->block = NULL;
+    google::protobuf::ArenaOptions options;
+    if (blockSize > 0)
+    {
+        arenaObj->block = new(std::nothrow) char[blockSize];
+        ALLOC_ASSERT(arenaObj->block)
+        options.initial_block = arenaObj->block;
+        options.initial_block_size = blockSize;
+    }
+    arenaObj->arena = new(std::nothrow) google::protobuf::Arena(options);
+    ALLOC_ASSERT(arenaObj->arena)
+    *arenaHandle = arenaObj;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqDestroyArena(ezmqArenaHandle_t *arenaHandle)
+{
+    VERIFY_NON_NULL(arenaHandle)
+    VERIFY_NON_NULL(*arenaHandle)
+    eventArena *arenaObj = static_cast<eventArena *>(*arenaHandle);
+    delete arenaObj->arena;
+    delete[] arenaObj->block;
+    delete arenaObj;
+    *arenaHandle = NULL;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqCreateEventInArena(ezmqArenaHandle_t arenaHandle, ezmqEventHandle_t *eventHandle)
+{
+    VERIFY_NON_NULL(arenaHandle)
+    VERIFY_NON_NULL(eventHandle)
+    *eventHandle = google::protobuf::Arena::CreateMessage<ezmq::Event>(
+            static_cast<eventArena *>(arenaHandle)->arena);
+    ALLOC_ASSERT(*eventHandle)
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqArenaReset(ezmqArenaHandle_t arenaHandle)
+{
+    VERIFY_NON_NULL(arenaHandle)
+    static_cast<eventArena *>(arenaHandle)->arena->Reset();
+    return CEZMQ_OK;
+}
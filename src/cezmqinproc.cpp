@@ -0,0 +1,154 @@
+/*******************************************************************************
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "cezmqinternal.h"
+
+using namespace ezmq;
+
+typedef std::vector<std::shared_ptr<inprocSubscriber> > subscriberList;
+
+struct ezmq::inprocEndpoint
+{
+    std::mutex lock;
+    bool bound;
+    // Replaced on connect/disconnect, so that publisher can deliver on a snapshot
+    // without holding the endpoint lock.
+    std::shared_ptr<const subscriberList> subscribers;
+};
+
+// Endpoints are few and named by application configuration, they are kept till exit.
+static std::mutex gEndpointLock;
+static std::unordered_map<std::string, inprocEndpoint *> gEndpoints;
+
+inprocEndpoint *ezmq::getInprocEndpoint(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(gEndpointLock);
+    std::unordered_map<std::string, inprocEndpoint *>::iterator it = gEndpoints.find(name);
+    if (it != gEndpoints.end())
+    {
+        return it->second;
+    }
+    inprocEndpoint *endpoint = new(std::nothrow) inprocEndpoint();
+    ALLOC_ASSERT(endpoint)
+    endpoint->bound = false;
+    endpoint->subscribers = std::make_shared<const subscriberList>();
+    gEndpoints[name] = endpoint;
+    return endpoint;
+}
+
+bool ezmq::bindInprocEndpoint(inprocEndpoint *endpoint)
+{
+    std::lock_guard<std::mutex> lock(endpoint->lock);
+    if (endpoint->bound)
+    {
+        return false;
+    }
+    endpoint->bound = true;
+    return true;
+}
+
+void ezmq::unbindInprocEndpoint(inprocEndpoint *endpoint)
+{
+    std::lock_guard<std::mutex> lock(endpoint->lock);
+    endpoint->bound = false;
+}
+
+void ezmq::connectInprocSubscriber(inprocEndpoint *endpoint,
+        const std::shared_ptr<inprocSubscriber> &subscriberObj)
+{
+    std::lock_guard<std::mutex> lock(endpoint->lock);
+    std::shared_ptr<subscriberList> subscribers = std::make_shared<subscriberList>(*endpoint->subscribers);
+    subscribers->push_back(subscriberObj);
+    endpoint->subscribers = subscribers;
+}
+
+void ezmq::disconnectInprocSubscriber(inprocEndpoint *endpoint,
+        const std::shared_ptr<inprocSubscriber> &subscriberObj)
+{
+    std::lock_guard<std::mutex> lock(endpoint->lock);
+    std::shared_ptr<subscriberList> subscribers = std::make_shared<subscriberList>();
+    for (size_t i = 0; i < endpoint->subscribers->size(); i++)
+    {
+        if ((*endpoint->subscribers)[i] != subscriberObj)
+        {
+            subscribers->push_back((*endpoint->subscribers)[i]);
+        }
+    }
+    endpoint->subscribers = subscribers;
+}
+
+static bool isSubscribed(const inprocSubscriber *subscriberObj, const std::string *topic)
+{
+    if (subscriberObj->all)
+    {
+        return true;
+    }
+    if (!topic)
+    {
+        return false;
+    }
+    return NULL != subscriberObj->topics.match(topic->c_str(), topic->size());
+}
+
+void ezmq::publishInproc(inprocEndpoint *endpoint, const std::string *topic, const EZMQMessage &event)
+{
+    std::shared_ptr<const subscriberList> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(endpoint->lock);
+        subscribers = endpoint->subscribers;
+    }
+    for (size_t i = 0; i < subscribers->size(); i++)
+    {
+        deliverInproc((*subscribers)[i].get(), topic, event);
+    }
+}
+
+bool ezmq::isInprocSubscribed(inprocSubscriber *subscriberObj, const std::string *topic)
+{
+    std::lock_guard<std::recursive_mutex> lock(subscriberObj->lock);
+    return subscriberObj->started && isSubscribed(subscriberObj, topic) &&
+            (!subscriberObj->accept || subscriberObj->accept(topic));
+}
+
+void ezmq::deliverInproc(inprocSubscriber *subscriberObj, const std::string *topic, const EZMQMessage &event)
+{
+    std::lock_guard<std::recursive_mutex> lock(subscriberObj->lock);
+    if (subscriberObj->started && isSubscribed(subscriberObj, topic))
+    {
+        subscriberObj->deliver(topic, event);
+    }
+}
+
+bool ezmq::parseEndpoint(const char *endpoint, std::string &transport, std::string &address)
+{
+    if (!endpoint)
+    {
+        return false;
+    }
+    const char *separator = strstr(endpoint, "://");
+    if (!separator || separator == endpoint || '\0' == separator[3])
+    {
+        return false;
+    }
+    transport.assign(endpoint, separator - endpoint);
+    address.assign(separator + 3);
+    return true;
+}
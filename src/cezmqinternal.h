@@ -0,0 +1,299 @@
+/*******************************************************************************
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+
+/**
+ * @file   cezmqinternal.h
+ *
+ * @brief This file contains internal structures shared between cezmq modules.
+ *        It is not part of cezmq APIs.
+ */
+
+#ifndef __EZMQ_INTERNAL_H_INCLUDED__
+#define __EZMQ_INTERNAL_H_INCLUDED__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "cezmqbytedata.h"
+#include "cezmqtopictrie.h"
+#include "EZMQByteData.h"
+
+namespace ezmq
+{
+    class CEZMQRateLimiter;
+
+    /**
+     * Validated and interned topic, shared by all the handles created for same topic name.
+     */
+    typedef struct internedTopic
+    {
+        std::string name;
+        std::atomic<int> refCount;
+        std::atomic<CEZMQRateLimiter *> limiter;
+    } internedTopic;
+
+    /**
+     * Validated list of topics, kept in the form EZMQ APIs take it.
+     */
+    typedef struct topicSet
+    {
+        std::list<std::string> topics;
+    } topicSet;
+
+    /**
+     * Byte data referring to application buffer. In-process and shared memory endpoints
+     * read the buffer itself. EZMQByteData keeps its own copy for TCP socket, so the copy is
+     * deferred till first TCP publish [detach] and application buffer is freed right after
+     * it. Same byte data may be published from several threads, detach is done once and the
+     * buffer is freed only after pinned readers are done with it.
+     */
+    class byteDataRef : public EZMQByteData
+    {
+        public:
+            byteDataRef(uint8_t *data, size_t dataLength, ezmqByteDataFreeCB freeFn, void *hint);
+            ~byteDataRef();
+            const uint8_t *data() const;
+            size_t length() const;
+            void detach();
+            const uint8_t *pin() const;
+            void unpin() const;
+
+        private:
+            std::atomic<uint8_t *> mRef;
+            size_t mRefLength;
+            ezmqByteDataFreeCB mFreeFn;
+            void *mHint;
+            mutable std::atomic<int> mReaders;
+            mutable std::mutex mLock;
+            mutable std::condition_variable mUnpinned;
+            std::once_flag mDetached;
+    };
+
+    /**
+     * Data of byte data kept valid for the lifetime of the view, even if it is detached
+     * by a concurrent publish.
+     */
+    class byteDataView
+    {
+        public:
+            explicit byteDataView(const EZMQByteData *byteData);
+            ~byteDataView();
+            const uint8_t *data() const { return mData; }
+
+        private:
+            byteDataView(const byteDataView &);
+            byteDataView &operator=(const byteDataView &);
+            const byteDataRef *mRef;
+            const uint8_t *mData;
+    };
+
+    /**
+     * Data pointer of byte data, works for byteDataRef as well. Pointer to application
+     * buffer is not valid once byte data is published, use byteDataView where it can be.
+     */
+    const uint8_t *getByteDataPtr(const EZMQByteData *byteData);
+
+    /**
+     * Data length of byte data, works for byteDataRef as well.
+     */
+    size_t getByteDataLength(const EZMQByteData *byteData);
+
+    /**
+     * Make sure EZMQByteData holds the data, to be called before handing it to EZMQ.
+     */
+    void detachByteData(const EZMQByteData *byteData);
+
+    /**
+     * Length of segmented byte data [segment lengths followed by segments] for given
+     * buffers, 0 if a buffer can not be carried.
+     */
+    size_t getSegmentedLength(const struct iovec *iov, int iovcnt);
+
+    /**
+     * Write given buffers as segmented byte data, data should be of getSegmentedLength.
+     */
+    void writeSegments(uint8_t *data, const struct iovec *iov, int iovcnt);
+
+    /**
+     * Copy of event/byte data, NULL if content type is not supported.
+     */
+    EZMQMessage *copyMessage(const EZMQMessage *message);
+
+    /**
+     * Destroy event/byte data created by application or by copyMessage.
+     */
+    void destroyMessage(EZMQMessage *message);
+
+    /**
+     * Check if message is event created in arena, which is freed only by its arena.
+     */
+    bool isArenaMessage(const EZMQMessage *message);
+
+    /**
+     * Length of byte data, serialized size of event.
+     */
+    size_t getMessageSize(const EZMQMessage *message);
+
+    /**
+     * Delivers in-process event to subscriber, topic is NULL for event published without topic.
+     */
+    typedef std::function<void(const std::string *topic, const EZMQMessage &event)> inprocDeliverCB;
+
+    /**
+     * Checks topic of event before it is parsed, false drops the event.
+     */
+    typedef std::function<bool(const std::string *topic)> inprocAcceptCB;
+
+    /**
+     * Subscriber connected to in-process endpoint. Lock is held while delivering, so that
+     * no event is delivered once subscriber is stopped.
+     */
+    typedef struct inprocSubscriber
+    {
+        std::recursive_mutex lock;
+        inprocDeliverCB deliver;
+        inprocAcceptCB accept;
+        bool started;
+        // Subscriptions for all events, counted same as topics.
+        int all;
+        // Subscribed topics with count of subscriptions of each.
+        CEZMQTopicTrie<int> topics;
+    } inprocSubscriber;
+
+    /**
+     * In-process endpoint [inproc://name], defined in cezmqinproc.cpp.
+     */
+    struct inprocEndpoint;
+
+    /**
+     * Get endpoint of given name, it is created if not exists.
+     */
+    inprocEndpoint *getInprocEndpoint(const std::string &name);
+
+    /**
+     * Bind publisher to endpoint, only one publisher can be bound to an endpoint at a time.
+     */
+    bool bindInprocEndpoint(inprocEndpoint *endpoint);
+    void unbindInprocEndpoint(inprocEndpoint *endpoint);
+
+    void connectInprocSubscriber(inprocEndpoint *endpoint,
+            const std::shared_ptr<inprocSubscriber> &subscriberObj);
+    void disconnectInprocSubscriber(inprocEndpoint *endpoint,
+            const std::shared_ptr<inprocSubscriber> &subscriberObj);
+
+    /**
+     * Deliver event to the matching subscribers of endpoint, on caller thread.
+     */
+    void publishInproc(inprocEndpoint *endpoint, const std::string *topic, const EZMQMessage &event);
+
+    /**
+     * Check if subscriber is started and subscribed to topic, and accepts it.
+     */
+    bool isInprocSubscribed(inprocSubscriber *subscriberObj, const std::string *topic);
+
+    /**
+     * Deliver event to subscriber if it is started and subscribed to topic.
+     */
+    void deliverInproc(inprocSubscriber *subscriberObj, const std::string *topic, const EZMQMessage &event);
+
+    /**
+     * Shared memory ring [shm://name], defined in cezmqshm.cpp. Written by a single
+     * publisher and read by any number of subscribers on the same host.
+     */
+    struct shmRing;
+
+    /**
+     * Create ring file for writing, existing ring of same name is replaced.
+     * Returns NULL on failure.
+     */
+    shmRing *createShmRing(const std::string &name, uint32_t slotCount, uint32_t slotSize);
+
+    /**
+     * Map ring created by publisher for reading. Returns NULL if ring does not exist.
+     */
+    shmRing *openShmRing(const std::string &name);
+
+    /**
+     * Unmap ring, ring file is removed if it was created by this process.
+     */
+    void closeShmRing(shmRing *ring);
+
+    /**
+     * Serialize event into next slot of ring. Serialized is the protobuf event already
+     * serialized by caller, it is copied as is instead of serializing event again.
+     */
+    CEZMQErrorCode writeShmRing(shmRing *ring, const std::string *topic, const EZMQMessage &event,
+            const std::string *serialized = NULL);
+
+    /**
+     * Sequence number of next event to be written.
+     */
+    uint64_t getShmRingHead(shmRing *ring);
+
+    /**
+     * Read events from cursor onward [at most maxEvents] and deliver them to subscriber.
+     * Events overwritten before they are read are skipped and added to lost.
+     *
+     * @return Number of slots consumed, 0 if no event is available.
+     */
+    int readShmRing(shmRing *ring, uint64_t &cursor, int maxEvents, inprocSubscriber *subscriberObj,
+            uint64_t &lost);
+
+    /**
+     * Check shared memory ring name: letters, digits, underscore, hyphen and dot.
+     */
+    bool isValidShmName(const std::string &name);
+
+    /**
+     * Split endpoint into transport [tcp/inproc/ipc] and address.
+     */
+    bool parseEndpoint(const char *endpoint, std::string &transport, std::string &address);
+
+    /**
+     * Check topic name as per EZMQ topic rules: letters, numerics and _ - . /
+     */
+    bool isValidTopic(const char *name);
+
+    /**
+     * Take one more reference of given topic.
+     */
+    void retainTopic(internedTopic *topicObj);
+
+    /**
+     * Release reference of given topic, topic is freed when last reference is released.
+     */
+    void releaseTopic(internedTopic *topicObj);
+
+    /**
+     * Count topic which got its rate limiter, to be called once per topic.
+     */
+    void addLimitedTopic();
+
+    /**
+     * Interned topic of given name if it has rate limiter, with one more reference taken.
+     * Returns NULL otherwise.
+     */
+    internedTopic *findLimitedTopic(const char *name);
+}
+
+#endif //__EZMQ_INTERNAL_H_INCLUDED__
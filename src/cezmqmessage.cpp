@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+
+#include "cezmqinternal.h"
+#include "EZMQMessage.h"
+#include "EZMQByteData.h"
+#include "Event.pb.h"
+
+using namespace ezmq;
+
+EZMQMessage *ezmq::copyMessage(const EZMQMessage *message)
+{
+    EZMQMessage *copy = NULL;
+    if(EZMQ_CONTENT_TYPE_PROTOBUF == message->getContentType())
+    {
+        Event *protoEvent = new(std::nothrow) Event();
+        ALLOC_ASSERT(protoEvent)
+        protoEvent->CopyFrom(*(static_cast<const Event *>(message)));
+        copy = protoEvent;
+    }
+    else if(EZMQ_CONTENT_TYPE_BYTEDATA == message->getContentType())
+    {
+        const EZMQByteData *byteData = static_cast<const EZMQByteData *>(message);
+        byteDataView view(byteData);
+        copy = new(std::nothrow) EZMQByteData(view.data(), getByteDataLength(byteData));
+        ALLOC_ASSERT(copy)
+    }
+    return copy;
+}
+
+void ezmq::destroyMessage(EZMQMessage *message)
+{
+    if(EZMQ_CONTENT_TYPE_PROTOBUF == message->getContentType())
+    {
+        delete static_cast<Event *>(message);
+    }
+    else
+    {
+        delete static_cast<EZMQByteData *>(message);
+    }
+}
+
+bool ezmq::isArenaMessage(const EZMQMessage *message)
+{
+    return EZMQ_CONTENT_TYPE_PROTOBUF == message->getContentType() &&
+            NULL != static_cast<const Event *>(message)->GetArena();
+}
+
+size_t ezmq::getMessageSize(const EZMQMessage *message)
+{
+    if(EZMQ_CONTENT_TYPE_PROTOBUF == message->getContentType())
+    {
+        return static_cast<const Event *>(message)->ByteSizeLong();
+    }
+    return getByteDataLength(static_cast<const EZMQByteData *>(message));
+}
@@ -15,7 +15,21 @@
  *
  *******************************************************************************/
 
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include "cezmqpublisher.h"
+#include "cezmqqueue.h"
+#include "cezmqinternal.h"
+#include "cezmqratelimit.h"
 #include "EZMQPublisher.h"
 #include "Event.pb.h"
 #include "EZMQByteData.h"
@@ -23,41 +37,861 @@
 
 using namespace ezmq;
 
+typedef struct preparedMessage
+{
+    ezmqMsgHandle_t event;
+    // Protobuf event serialized once, written as is to shared memory rings.
+    std::string serialized;
+    std::atomic<int> refCount;
+} preparedMessage;
+
+typedef struct queuedMessage
+{
+    ezmqMsgHandle_t event;
+    preparedMessage *prepared;
+    internedTopic *topicObj;
+    bool hasTopic;
+    bool conflated;
+    std::string topic;
+} queuedMessage;
+
+typedef struct asyncSender
+{
+    explicit asyncSender(size_t queueSize) : queue(queueSize) {}
+    CEZMQQueue<queuedMessage> queue;
+    CEZMQQueuePolicy policy;
+    int flushTimeout;
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> idle;
+    std::atomic<int> blocked;
+    std::atomic<int> pending;
+    std::atomic<uint64_t> dropped;
+    std::mutex conflateLock;
+    std::unordered_map<std::string, queuedMessage> conflated;
+    std::mutex lock;
+    std::condition_variable wakeup;
+    std::condition_variable progress;
+} asyncSender;
+
 typedef struct publisher
 {
     EZMQPublisher *handle;
+    std::vector<inprocEndpoint *> endpoints;
+    std::vector<std::string> shmNames;
+    std::vector<shmRing *> rings;
+    uint32_t shmSlotCount;
+    uint32_t shmSlotSize;
+    std::atomic<bool> bound;
+    ezmqErrorCB errorCb;
+    asyncSender *sender;
+    std::atomic<CEZMQRateLimiter *> limiter;
 } publisher;
 
 void startCallback(EZMQErrorCode /*code*/, ezmqStartCB /*startCb*/){}
 void stopCallback(EZMQErrorCode /*code*/, ezmqStopCB /*stopCb*/){}
 void errorCalback(EZMQErrorCode /*code*/, ezmqErrorCB /*errorCb*/){}
 
-static EZMQPublisher *getPubInstance(ezmqPubHandle_t pubHandle)
+template <typename Destination>
+static CEZMQErrorCode sendTo(EZMQPublisher *publisherObj, const Destination &destination,
+        const ezmqMsgHandle_t event)
+{
+    const ezmq::EZMQMessage *ezmqMessage = static_cast<const ezmq::EZMQMessage *>(event);
+    if(EZMQ_CONTENT_TYPE_PROTOBUF == ezmqMessage->getContentType())
+    {
+        return CEZMQErrorCode(publisherObj->publish(destination,
+                *(static_cast<const ezmq::Event *>(event))));
+    }
+    else if(EZMQ_CONTENT_TYPE_BYTEDATA == ezmqMessage->getContentType())
+    {
+        const ezmq::EZMQByteData *byteData = static_cast<const ezmq::EZMQByteData *>(event);
+        detachByteData(byteData);
+        return CEZMQErrorCode(publisherObj->publish(destination, *byteData));
+    }
+    else
+    {
+        return CEZMQ_INVALID_CONTENT_TYPE;
+    }
+}
+
+static CEZMQErrorCode sendMessage(EZMQPublisher *publisherObj, const char *topic,
+        const ezmqMsgHandle_t event)
+{
+    if (topic)
+    {
+        return sendTo(publisherObj, topic, event);
+    }
+    const ezmq::EZMQMessage *ezmqMessage = static_cast<const ezmq::EZMQMessage *>(event);
+    if(EZMQ_CONTENT_TYPE_PROTOBUF == ezmqMessage->getContentType())
+    {
+        return CEZMQErrorCode(publisherObj->publish(*(static_cast<const ezmq::Event *>(event))));
+    }
+    else if(EZMQ_CONTENT_TYPE_BYTEDATA == ezmqMessage->getContentType())
+    {
+        const ezmq::EZMQByteData *byteData = static_cast<const ezmq::EZMQByteData *>(event);
+        detachByteData(byteData);
+        return CEZMQErrorCode(publisherObj->publish(*byteData));
+    }
+    else
+    {
+        return CEZMQ_INVALID_CONTENT_TYPE;
+    }
+}
+
+static bool isValidContentType(const ezmqMsgHandle_t event)
+{
+    const ezmq::EZMQMessage *ezmqMessage = static_cast<const ezmq::EZMQMessage *>(event);
+    return EZMQ_CONTENT_TYPE_PROTOBUF == ezmqMessage->getContentType() ||
+            EZMQ_CONTENT_TYPE_BYTEDATA == ezmqMessage->getContentType();
+}
+
+static CEZMQErrorCode deliverLocal(publisher *pubObj, const std::string *topic, const ezmqMsgHandle_t event,
+        const std::string *serialized)
+{
+    const ezmq::EZMQMessage *ezmqMessage = static_cast<const ezmq::EZMQMessage *>(event);
+    for (size_t i = 0; i < pubObj->endpoints.size(); i++)
+    {
+        publishInproc(pubObj->endpoints[i], topic, *ezmqMessage);
+    }
+    CEZMQErrorCode result = CEZMQ_OK;
+    for (size_t i = 0; i < pubObj->rings.size(); i++)
+    {
+        CEZMQErrorCode ringResult = writeShmRing(pubObj->rings[i], topic, *ezmqMessage, serialized);
+        if (CEZMQ_OK != ringResult)
+        {
+            result = ringResult;
+        }
+    }
+    return result;
+}
+
+/**
+ * Serialize protobuf event into buffer if it is written to shared memory rings more than
+ * once [rings x topics], so that rings copy the same bytes instead of serializing it again.
+ */
+static const std::string *serializeForRings(publisher *pubObj, const ezmqMsgHandle_t event,
+        size_t topicCount, const std::string *serialized, std::string &buffer)
+{
+    const ezmq::EZMQMessage *ezmqMessage = static_cast<const ezmq::EZMQMessage *>(event);
+    if (serialized || pubObj->rings.size() * topicCount < 2 ||
+            EZMQ_CONTENT_TYPE_PROTOBUF != ezmqMessage->getContentType())
+    {
+        return serialized;
+    }
+    static_cast<const ezmq::Event *>(ezmqMessage)->SerializeToString(&buffer);
+    return &buffer;
+}
+
+static CEZMQErrorCode publishLocal(publisher *pubObj, const char *topic, const ezmqMsgHandle_t event,
+        const std::string *serialized)
+{
+    if (!isValidContentType(event))
+    {
+        return CEZMQ_INVALID_CONTENT_TYPE;
+    }
+    if (topic && !isValidTopic(topic))
+    {
+        return CEZMQ_INVALID_TOPIC;
+    }
+    std::string buffer;
+    serialized = serializeForRings(pubObj, event, 1, serialized, buffer);
+    if (!topic)
+    {
+        return deliverLocal(pubObj, NULL, event, serialized);
+    }
+    std::string name(topic);
+    return deliverLocal(pubObj, &name, event, serialized);
+}
+
+static CEZMQErrorCode publishLocal(publisher *pubObj, const std::string &topic,
+        const ezmqMsgHandle_t event, const std::string *serialized)
+{
+    if (!isValidContentType(event))
+    {
+        return CEZMQ_INVALID_CONTENT_TYPE;
+    }
+    if (!isValidTopic(topic.c_str()))
+    {
+        return CEZMQ_INVALID_TOPIC;
+    }
+    std::string buffer;
+    serialized = serializeForRings(pubObj, event, 1, serialized, buffer);
+    return deliverLocal(pubObj, &topic, event, serialized);
+}
+
+static CEZMQErrorCode publishLocal(publisher *pubObj, const std::list<std::string> &topics,
+        const ezmqMsgHandle_t event, const std::string *serialized)
+{
+    if (!isValidContentType(event))
+    {
+        return CEZMQ_INVALID_CONTENT_TYPE;
+    }
+    for (std::list<std::string>::const_iterator it = topics.begin(); it != topics.end(); ++it)
+    {
+        if (!isValidTopic(it->c_str()))
+        {
+            return CEZMQ_INVALID_TOPIC;
+        }
+    }
+    std::string buffer;
+    serialized = serializeForRings(pubObj, event, topics.size(), serialized, buffer);
+    CEZMQErrorCode result = CEZMQ_OK;
+    for (std::list<std::string>::const_iterator it = topics.begin(); it != topics.end(); ++it)
+    {
+        CEZMQErrorCode topicResult = deliverLocal(pubObj, &*it, event, serialized);
+        if (CEZMQ_OK != topicResult)
+        {
+            result = topicResult;
+        }
+    }
+    return result;
+}
+
+/**
+ * Publish on TCP socket if publisher has one, then to its bound in-process endpoints.
+ * Serialized protobuf event, if given, is written to shared memory rings as is. EZMQ
+ * takes the event itself, so it is still serialized for TCP socket.
+ */
+template <typename Destination>
+static CEZMQErrorCode publishTo(publisher *pubObj, const Destination &destination,
+        const ezmqMsgHandle_t event, const std::string *serialized = NULL)
+{
+    if (pubObj->handle)
+    {
+        CEZMQErrorCode result = sendTo(pubObj->handle, destination, event);
+        if (CEZMQ_OK != result || !pubObj->bound.load())
+        {
+            return result;
+        }
+    }
+    else if (!pubObj->bound.load())
+    {
+        return CEZMQ_ERROR;
+    }
+    return publishLocal(pubObj, destination, event, serialized);
+}
+
+static CEZMQErrorCode publishMessage(publisher *pubObj, const char *topic,
+        const ezmqMsgHandle_t event, const std::string *serialized = NULL)
+{
+    if (pubObj->handle)
+    {
+        CEZMQErrorCode result = sendMessage(pubObj->handle, topic, event);
+        if (CEZMQ_OK != result || !pubObj->bound.load())
+        {
+            return result;
+        }
+    }
+    else if (!pubObj->bound.load())
+    {
+        return CEZMQ_ERROR;
+    }
+    return publishLocal(pubObj, topic, event, serialized);
+}
+
+static CEZMQRateLimiter *getLimiter(std::atomic<CEZMQRateLimiter *> &limiter, bool *created = NULL)
+{
+    CEZMQRateLimiter *current = limiter.load();
+    if (current)
+    {
+        return current;
+    }
+    CEZMQRateLimiter *limiterObj = new(std::nothrow) CEZMQRateLimiter();
+    ALLOC_ASSERT(limiterObj)
+    if (limiter.compare_exchange_strong(current, limiterObj))
+    {
+        if (created)
+        {
+            *created = true;
+        }
+        return limiterObj;
+    }
+    delete limiterObj;
+    return current;
+}
+
+/**
+ * Take rate tokens of publisher and topic for an event sent on given number of topics.
+ * Returns 0 on success, otherwise time to wait [in microseconds] and the limiter which
+ * is exhausted.
+ */
+static int64_t acquireRate(publisher *pubObj, internedTopic *topicObj, const ezmqMsgHandle_t event,
+        uint32_t topicCount, CEZMQRateLimiter **limitedBy)
+{
+    CEZMQRateLimiter *pubLimiter = pubObj->limiter.load();
+    CEZMQRateLimiter *topicLimiter = topicObj ? topicObj->limiter.load() : NULL;
+    if (!pubLimiter && !topicLimiter)
+    {
+        return 0;
+    }
+    size_t bytes = 0;
+    if ((pubLimiter && pubLimiter->countsBytes()) || (topicLimiter && topicLimiter->countsBytes()))
+    {
+        bytes = getMessageSize(static_cast<const ezmq::EZMQMessage *>(event)) * topicCount;
+    }
+    int64_t wait = topicLimiter ? topicLimiter->acquire(bytes) : 0;
+    if (wait > 0)
+    {
+        *limitedBy = topicLimiter;
+        return wait;
+    }
+    wait = pubLimiter ? pubLimiter->acquire(bytes, topicCount) : 0;
+    if (wait > 0)
+    {
+        if (topicLimiter)
+        {
+            topicLimiter->release(bytes);
+        }
+        *limitedBy = pubLimiter;
+    }
+    return wait;
+}
+
+/**
+ * Take rate tokens for event which is going to be published. Event with content type
+ * which can not be published is rejected before taking any token.
+ */
+static CEZMQErrorCode checkRate(ezmqPubHandle_t pubHandle, internedTopic *topicObj,
+        const ezmqMsgHandle_t event, uint32_t topicCount = 1)
+{
+    if (!isValidContentType(event))
+    {
+        return CEZMQ_INVALID_CONTENT_TYPE;
+    }
+    CEZMQRateLimiter *limitedBy = NULL;
+    if (acquireRate(static_cast<publisher *>(pubHandle), topicObj, event, topicCount, &limitedBy) > 0)
+    {
+        limitedBy->mRejected.fetch_add(1);
+        return CEZMQ_RATE_LIMITED;
+    }
+    return CEZMQ_OK;
+}
+
+/**
+ * Validate topic name and take rate tokens of publisher and of the topic, if rate of
+ * that topic is limited using its topic handle. Topic is NULL for event without topic.
+ */
+static CEZMQErrorCode checkTopicRate(ezmqPubHandle_t pubHandle, const char *topic,
+        const ezmqMsgHandle_t event)
+{
+    if (topic && !isValidTopic(topic))
+    {
+        return CEZMQ_INVALID_TOPIC;
+    }
+    internedTopic *topicObj = topic ? findLimitedTopic(topic) : NULL;
+    CEZMQErrorCode result = checkRate(pubHandle, topicObj, event);
+    if (topicObj)
+    {
+        releaseTopic(topicObj);
+    }
+    return result;
+}
+
+// Sender thread waits for rate tokens instead of rejecting the event.
+static bool paceRate(publisher *pubObj, const queuedMessage &item)
+{
+    internedTopic *topicObj = item.topicObj;
+    if (!topicObj && item.hasTopic)
+    {
+        topicObj = findLimitedTopic(item.topic.c_str());
+    }
+    CEZMQRateLimiter *limitedBy = NULL;
+    int64_t wait = acquireRate(pubObj, topicObj, item.event, 1, &limitedBy);
+    if (wait > 0)
+    {
+        limitedBy->mPaced.fetch_add(1);
+    }
+    while (wait > 0 && pubObj->sender->running.load())
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(wait < 10000 ? wait : 10000));
+        wait = acquireRate(pubObj, topicObj, item.event, 1, &limitedBy);
+    }
+    if (topicObj && topicObj != item.topicObj)
+    {
+        releaseTopic(topicObj);
+    }
+    return wait <= 0;
+}
+
+static void releasePrepared(preparedMessage *prepared)
+{
+    if (1 == prepared->refCount.fetch_sub(1))
+    {
+        destroyMessage(static_cast<ezmq::EZMQMessage *>(prepared->event));
+        delete prepared;
+    }
+}
+
+static void releaseQueued(queuedMessage &item)
+{
+    if (item.topicObj)
+    {
+        releaseTopic(item.topicObj);
+    }
+    if (item.prepared)
+    {
+        releasePrepared(item.prepared);
+    }
+    else
+    {
+        destroyMessage(static_cast<ezmq::EZMQMessage *>(item.event));
+    }
+}
+
+static const std::string &conflationKey(const queuedMessage &item)
+{
+    static const std::string noTopic;
+    if (item.topicObj)
+    {
+        return item.topicObj->name;
+    }
+    return item.hasTopic ? item.topic : noTopic;
+}
+
+// Queue holds only a marker for conflated topic, latest message is kept in the table.
+static void takeConflated(asyncSender *sender, queuedMessage &item)
+{
+    if (!item.conflated)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sender->conflateLock);
+    std::unordered_map<std::string, queuedMessage>::iterator it = sender->conflated.find(item.topic);
+    item = std::move(it->second);
+    sender->conflated.erase(it);
+}
+
+static void notifyProgress(asyncSender *sender)
+{
+    std::lock_guard<std::mutex> lock(sender->lock);
+    sender->progress.notify_all();
+}
+
+static void senderLoop(publisher *pubObj)
+{
+    asyncSender *sender = pubObj->sender;
+    queuedMessage item;
+    while (sender->running.load())
+    {
+        if (sender->queue.pop(item))
+        {
+            // Producers blocked on full queue can push now, see enqueueMessage.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sender->blocked.load() > 0)
+            {
+                notifyProgress(sender);
+            }
+            takeConflated(sender, item);
+            if (!paceRate(pubObj, item))
+            {
+                // Stopped while waiting for rate tokens.
+                releaseQueued(item);
+                sender->pending.fetch_sub(1);
+                sender->dropped.fetch_add(1);
+                notifyProgress(sender);
+                continue;
+            }
+            const std::string *serialized = item.prepared ? &item.prepared->serialized : NULL;
+            CEZMQErrorCode result = item.topicObj ?
+                    publishTo(pubObj, item.topicObj->name, item.event, serialized) :
+                    publishMessage(pubObj, item.hasTopic ? item.topic.c_str() : NULL, item.event,
+                            serialized);
+            releaseQueued(item);
+            if (CEZMQ_OK != result && pubObj->errorCb)
+            {
+                pubObj->errorCb(result);
+            }
+            if (1 == sender->pending.fetch_sub(1))
+            {
+                notifyProgress(sender);
+            }
+            continue;
+        }
+
+        // Announce idle state before re-checking the queue, so that a producer
+        // either sees the flag and wakes us up or its message is seen here.
+        std::unique_lock<std::mutex> lock(sender->lock);
+        sender->idle.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (0 == sender->queue.size() && sender->running.load())
+        {
+            sender->wakeup.wait(lock);
+        }
+        sender->idle.store(false);
+    }
+}
+
+static void wakeSender(asyncSender *sender)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sender->idle.load())
+    {
+        std::lock_guard<std::mutex> lock(sender->lock);
+        sender->wakeup.notify_one();
+    }
+}
+
+static void startSender(publisher *pubObj)
+{
+    asyncSender *sender = pubObj->sender;
+    if (sender->thread.joinable())
+    {
+        return;
+    }
+    sender->running.store(true);
+    sender->thread = std::thread(senderLoop, pubObj);
+}
+
+static void stopSender(asyncSender *sender)
+{
+    if (sender->thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(sender->lock);
+            sender->running.store(false);
+            sender->wakeup.notify_one();
+        }
+        sender->thread.join();
+    }
+
+    // Messages which could not be sent before stop are discarded.
+    queuedMessage item;
+    while (sender->queue.pop(item))
+    {
+        takeConflated(sender, item);
+        releaseQueued(item);
+        sender->pending.fetch_sub(1);
+        sender->dropped.fetch_add(1);
+    }
+    notifyProgress(sender);
+}
+
+static CEZMQErrorCode flushSender(asyncSender *sender, int timeout)
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() +
+            std::chrono::milliseconds(timeout);
+    std::unique_lock<std::mutex> lock(sender->lock);
+    while (sender->pending.load() > 0)
+    {
+        if (!sender->running.load() ||
+                std::cv_status::timeout == sender->progress.wait_until(lock, deadline))
+        {
+            return (0 == sender->pending.load()) ? CEZMQ_OK : CEZMQ_ERROR;
+        }
+    }
+    return CEZMQ_OK;
+}
+
+static CEZMQErrorCode conflateMessage(asyncSender *sender, queuedMessage &item)
+{
+    std::lock_guard<std::mutex> lock(sender->conflateLock);
+    std::string key = conflationKey(item);
+    std::unordered_map<std::string, queuedMessage>::iterator it = sender->conflated.find(key);
+    if (it != sender->conflated.end())
+    {
+        // Topic is already waiting in queue, just replace its message.
+        releaseQueued(it->second);
+        it->second = std::move(item);
+        sender->dropped.fetch_add(1);
+        return CEZMQ_OK;
+    }
+
+    // Sender needs conflateLock to take the message, so marker can be pushed before
+    // the message is put in table.
+    queuedMessage marker;
+    marker.event = NULL;
+    marker.prepared = NULL;
+    marker.topicObj = NULL;
+    marker.hasTopic = true;
+    marker.conflated = true;
+    marker.topic = key;
+    sender->pending.fetch_add(1);
+    if (!sender->queue.push(marker))
+    {
+        sender->pending.fetch_sub(1);
+        sender->dropped.fetch_add(1);
+        return CEZMQ_QUEUE_FULL;
+    }
+    sender->conflated[key] = std::move(item);
+    return CEZMQ_OK;
+}
+
+static CEZMQErrorCode enqueueMessage(asyncSender *sender, queuedMessage &item)
+{
+    if (CEZMQ_QUEUE_CONFLATE == sender->policy)
+    {
+        CEZMQErrorCode result = conflateMessage(sender, item);
+        if (CEZMQ_OK == result)
+        {
+            wakeSender(sender);
+        }
+        return result;
+    }
+    sender->pending.fetch_add(1);
+    while (!sender->queue.push(item))
+    {
+        if (CEZMQ_QUEUE_DROP_OLDEST == sender->policy)
+        {
+            queuedMessage oldest;
+            if (sender->queue.pop(oldest))
+            {
+                releaseQueued(oldest);
+                sender->pending.fetch_sub(1);
+                sender->dropped.fetch_add(1);
+            }
+        }
+        else if (CEZMQ_QUEUE_BLOCK == sender->policy && sender->running.load())
+        {
+            // Announce blocked state before re-checking the queue, so that sender thread
+            // either sees it and notifies after its next pop or the free slot is seen here.
+            std::unique_lock<std::mutex> lock(sender->lock);
+            sender->blocked.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sender->queue.size() >= sender->queue.capacity() && sender->running.load())
+            {
+                sender->progress.wait(lock);
+            }
+            sender->blocked.fetch_sub(1);
+        }
+        else
+        {
+            sender->pending.fetch_sub(1);
+            sender->dropped.fetch_add(1);
+            return CEZMQ_QUEUE_FULL;
+        }
+    }
+    wakeSender(sender);
+    return CEZMQ_OK;
+}
+
+static bool hasLocalEndpoints(publisher *pubObj)
+{
+    return !pubObj->endpoints.empty() || !pubObj->shmNames.empty();
+}
+
+// Rings are created on first start and kept till publisher is destroyed, so that
+// publishing threads never see a ring being closed.
+static bool createRings(publisher *pubObj)
+{
+    if (pubObj->rings.size() == pubObj->shmNames.size())
+    {
+        return true;
+    }
+    for (size_t i = 0; i < pubObj->shmNames.size(); i++)
+    {
+        shmRing *ring = createShmRing(pubObj->shmNames[i], pubObj->shmSlotCount, pubObj->shmSlotSize);
+        if (!ring)
+        {
+            for (size_t j = 0; j < pubObj->rings.size(); j++)
+            {
+                closeShmRing(pubObj->rings[j]);
+            }
+            pubObj->rings.clear();
+            return false;
+        }
+        pubObj->rings.push_back(ring);
+    }
+    return true;
+}
+
+static bool bindEndpoints(publisher *pubObj)
+{
+    for (size_t i = 0; i < pubObj->endpoints.size(); i++)
+    {
+        if (!bindInprocEndpoint(pubObj->endpoints[i]))
+        {
+            while (i-- > 0)
+            {
+                unbindInprocEndpoint(pubObj->endpoints[i]);
+            }
+            return false;
+        }
+    }
+    if (!createRings(pubObj))
+    {
+        for (size_t i = 0; i < pubObj->endpoints.size(); i++)
+        {
+            unbindInprocEndpoint(pubObj->endpoints[i]);
+        }
+        return false;
+    }
+    pubObj->bound.store(true);
+    return true;
+}
+
+static void unbindEndpoints(publisher *pubObj)
+{
+    pubObj->bound.store(false);
+    for (size_t i = 0; i < pubObj->endpoints.size(); i++)
+    {
+        unbindInprocEndpoint(pubObj->endpoints[i]);
+    }
+}
+
+static EZMQPublisher *createTcpPublisher(int port, ezmqStartCB startCb,
+        ezmqStopCB stopCb, ezmqErrorCB errorCb)
+{
+    EZMQPublisher *publisherObj = nullptr ;
+    publisherObj =  new(std::nothrow) EZMQPublisher(port,  std::bind(startCallback, std::placeholders::_1, startCb),
+                                                                               std::bind(stopCallback,  std::placeholders::_1, stopCb),
+                                                                               std::bind(errorCalback,  std::placeholders::_1, errorCb));
+    ALLOC_ASSERT(publisherObj)
+    return publisherObj;
+}
+
+static void createPublisher(EZMQPublisher *publisherObj, ezmqErrorCB errorCb, ezmqPubHandle_t *pubHandle)
+{
+    publisher *pubInstance = new(std::nothrow) publisher();
+    if(!pubInstance)
+    {
+        delete publisherObj;
+        abort();
+    }
+    pubInstance->handle = publisherObj;
+    pubInstance->shmSlotCount = CEZMQ_SHM_SLOT_COUNT;
+    pubInstance->shmSlotSize = CEZMQ_SHM_SLOT_SIZE;
+    pubInstance->bound.store(false);
+    pubInstance->errorCb = errorCb;
+    pubInstance->sender = NULL;
+    pubInstance->limiter.store(NULL);
+    *pubHandle = pubInstance;
+}
+
+CEZMQErrorCode ezmqCreatePublisher(int port, ezmqStartCB startCb,
+        ezmqStopCB stopCb, ezmqErrorCB errorCb, ezmqPubHandle_t *pubHandle)
+{
+    if (port < 0)
+    {
+        return CEZMQ_ERROR;
+    }
+    createPublisher(createTcpPublisher(port, startCb, stopCb, errorCb), errorCb, pubHandle);
+    return CEZMQ_OK;
+}
+
+/**
+ * Parse port of TCP endpoint address [*:port].
+ */
+static int parseBindPort(const std::string &address)
+{
+    if (0 != address.compare(0, 2, "*:") || address.size() == 2)
+    {
+        return -1;
+    }
+    char *end = NULL;
+    long port = strtol(address.c_str() + 2, &end, 10);
+    if ('\0' != *end || port < 0 || port > 65535)
+    {
+        return -1;
+    }
+    return (int) port;
+}
+
+CEZMQErrorCode ezmqCreatePublisherWithEndpoints(const char **endpoints, int count,
+        ezmqStartCB startCb, ezmqStopCB stopCb, ezmqErrorCB errorCb, ezmqPubHandle_t *pubHandle)
+{
+    VERIFY_NON_NULL(endpoints)
+    VERIFY_NON_NULL(pubHandle)
+    if (count <= 0)
+    {
+        return CEZMQ_ERROR;
+    }
+    int port = -1;
+    std::vector<std::string> names;
+    std::vector<std::string> shmNames;
+    for (int i = 0; i < count; i++)
+    {
+        std::string transport;
+        std::string address;
+        if (!parseEndpoint(endpoints[i], transport, address))
+        {
+            return CEZMQ_ERROR;
+        }
+        if ("tcp" == transport)
+        {
+            // EZMQ publisher binds a single TCP port.
+            if (port >= 0 || (port = parseBindPort(address)) < 0)
+            {
+                return CEZMQ_ERROR;
+            }
+        }
+        else if ("inproc" == transport)
+        {
+            names.push_back(address);
+        }
+        else if ("shm" == transport && isValidShmName(address))
+        {
+            shmNames.push_back(address);
+        }
+        else
+        {
+            return CEZMQ_ERROR;
+        }
+    }
+    EZMQPublisher *publisherObj = NULL;
+    if (port >= 0)
+    {
+        publisherObj = createTcpPublisher(port, startCb, stopCb, errorCb);
+    }
+    createPublisher(publisherObj, errorCb, pubHandle);
+    publisher *pubObj = static_cast<publisher *>(*pubHandle);
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        pubObj->endpoints.push_back(getInprocEndpoint(names[i]));
+    }
+    pubObj->shmNames = shmNames;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqInitPubOptions(CEZMQPubOptions *options, int version)
 {
-    publisher *pubObj = static_cast<publisher *>(pubHandle);
-    return pubObj->handle;
+    VERIFY_NON_NULL(options)
+    if (version < 1 || version > CEZMQ_PUB_OPTIONS_VERSION)
+    {
+        return CEZMQ_ERROR;
+    }
+    options->version = version;
+    options->asyncQueueSize = 0;
+    options->asyncQueuePolicy = CEZMQ_QUEUE_DROP_NEWEST;
+    options->flushTimeout = 0;
+    return CEZMQ_OK;
 }
 
-CEZMQErrorCode ezmqCreatePublisher(int port, ezmqStartCB startCb,
-        ezmqStopCB stopCb, ezmqErrorCB errorCb, ezmqPubHandle_t *pubHandle)
+CEZMQErrorCode ezmqCreatePublisherEx(int port, const CEZMQPubOptions *options,
+        ezmqStartCB startCb, ezmqStopCB stopCb, ezmqErrorCB errorCb, ezmqPubHandle_t *pubHandle)
 {
-    if (port < 0)
+    VERIFY_NON_NULL(options)
+    VERIFY_NON_NULL(pubHandle)
+    if (options->version < 1 || options->version > CEZMQ_PUB_OPTIONS_VERSION ||
+            options->asyncQueueSize < 0 || options->flushTimeout < 0)
     {
         return CEZMQ_ERROR;
     }
-    EZMQPublisher *publisherObj = nullptr ;
-    publisherObj =  new(std::nothrow) EZMQPublisher(port,  std::bind(startCallback, std::placeholders::_1, startCb),
-                                                                               std::bind(stopCallback,  std::placeholders::_1, stopCb),
-                                                                               std::bind(errorCalback,  std::placeholders::_1, errorCb));
-    ALLOC_ASSERT(publisherObj)
-    publisher *pubInstance = new(std::nothrow) publisher();
-    if(!pubInstance)
+    CEZMQErrorCode result = ezmqCreatePublisher(port, startCb, stopCb, errorCb, pubHandle);
+    if (CEZMQ_OK != result || 0 == options->asyncQueueSize)
     {
-        delete publisherObj;
-        abort();
+        return result;
     }
-    pubInstance->handle = publisherObj;
-    *pubHandle = pubInstance;
+    result = ezmqSetPublisherAsync(*pubHandle, options->asyncQueueSize, options->asyncQueuePolicy,
+            options->flushTimeout);
+    if (CEZMQ_OK != result)
+    {
+        ezmqDestroyPublisher(pubHandle);
+    }
+    return result;
+}
+
+CEZMQErrorCode ezmqGetPubOptions(ezmqPubHandle_t pubHandle, CEZMQPubOptions *options)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(options)
+    if (options->version < 1 || options->version > CEZMQ_PUB_OPTIONS_VERSION)
+    {
+        return CEZMQ_ERROR;
+    }
+    asyncSender *sender = static_cast<publisher *>(pubHandle)->sender;
+    options->asyncQueueSize = sender ? sender->queue.capacity() : 0;
+    options->asyncQueuePolicy = sender ? sender->policy : CEZMQ_QUEUE_DROP_NEWEST;
+    options->flushTimeout = sender ? sender->flushTimeout : 0;
     return CEZMQ_OK;
 }
 
@@ -65,11 +899,15 @@ CEZMQErrorCode ezmqSetServerPrivateKey(ezmqPubHandle_t pubHandle, const char *ke
 {
     VERIFY_NON_NULL(pubHandle)
     VERIFY_NON_NULL(key)
-    EZMQPublisher *publisherObj = getPubInstance(pubHandle);
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
+    if (!pubObj->handle)
+    {
+        return CEZMQ_ERROR;
+    }
     EZMQErrorCode errorCode = EZMQ_ERROR;
     try
     {
-        errorCode = publisherObj->setServerPrivateKey(key);
+        errorCode = pubObj->handle->setServerPrivateKey(key);
     }
     catch(EZMQException &e)
     {
@@ -78,32 +916,77 @@ CEZMQErrorCode ezmqSetServerPrivateKey(ezmqPubHandle_t pubHandle, const char *ke
     return CEZMQErrorCode(errorCode);
 }
 
-CEZMQErrorCode ezmqStartPublisher(ezmqPubHandle_t pubHandle)
+CEZMQErrorCode ezmqSetPublisherShmSize(ezmqPubHandle_t pubHandle, int slotCount, int slotSize)
 {
     VERIFY_NON_NULL(pubHandle)
-    EZMQPublisher *publisherObj = getPubInstance(pubHandle);
-    return CEZMQErrorCode(publisherObj->start());
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
+    if (slotCount < 2 || slotCount > CEZMQ_SHM_MAX_SLOT_COUNT || slotSize <= 0 ||
+            slotSize > CEZMQ_SHM_MAX_SLOT_SIZE || !pubObj->rings.empty())
+    {
+        return CEZMQ_ERROR;
+    }
+    pubObj->shmSlotCount = slotCount;
+    pubObj->shmSlotSize = slotSize;
+    return CEZMQ_OK;
 }
 
-CEZMQErrorCode ezmqPublish(ezmqPubHandle_t pubHandle, const ezmqMsgHandle_t event)
+CEZMQErrorCode ezmqSetPublisherAsync(ezmqPubHandle_t pubHandle, int queueSize,
+        CEZMQQueuePolicy policy, int flushTimeout)
 {
     VERIFY_NON_NULL(pubHandle)
-    VERIFY_NON_NULL(event)
-    EZMQPublisher *publisherObj = getPubInstance(pubHandle);
+    if (queueSize <= 0 || flushTimeout < 0)
+    {
+        return CEZMQ_ERROR;
+    }
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
+    if (pubObj->sender)
+    {
+        return CEZMQ_ERROR;
+    }
+    asyncSender *sender = new(std::nothrow) asyncSender(queueSize);
+    ALLOC_ASSERT(sender)
+    sender->policy = policy;
+    sender->flushTimeout = flushTimeout;
+    sender->running.store(false);
+    sender->idle.store(false);
+    sender->blocked.store(0);
+    sender->pending.store(0);
+    sender->dropped.store(0);
+    pubObj->sender = sender;
+    return CEZMQ_OK;
+}
 
-    const ezmq::EZMQMessage *ezmqMessage = static_cast<const ezmq::EZMQMessage *>(event);
-    if(EZMQ_CONTENT_TYPE_PROTOBUF == ezmqMessage->getContentType())
+CEZMQErrorCode ezmqStartPublisher(ezmqPubHandle_t pubHandle)
+{
+    VERIFY_NON_NULL(pubHandle)
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
+    if (hasLocalEndpoints(pubObj) && !bindEndpoints(pubObj))
     {
-        return CEZMQErrorCode(publisherObj->publish(*(static_cast<const ezmq::Event *>(event))));
+        return CEZMQ_ERROR;
     }
-    else if(EZMQ_CONTENT_TYPE_BYTEDATA == ezmqMessage->getContentType())
+    CEZMQErrorCode result = pubObj->handle ? CEZMQErrorCode(pubObj->handle->start()) : CEZMQ_OK;
+    if (CEZMQ_OK != result && hasLocalEndpoints(pubObj))
     {
-        return CEZMQErrorCode(publisherObj->publish(*(static_cast<const ezmq::EZMQByteData *>(event))));
+        unbindEndpoints(pubObj);
     }
-    else
+    if (CEZMQ_OK == result && pubObj->sender)
     {
-        return CEZMQ_INVALID_CONTENT_TYPE;
+        startSender(pubObj);
+    }
+    return result;
+}
+
+CEZMQErrorCode ezmqPublish(ezmqPubHandle_t pubHandle, const ezmqMsgHandle_t event)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(event)
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
+    CEZMQErrorCode result = checkRate(pubHandle, NULL, event);
+    if (CEZMQ_OK != result)
+    {
+        return result;
     }
+    return publishMessage(pubObj, NULL, event);
 }
 
 CEZMQErrorCode ezmqPublishOnTopic(ezmqPubHandle_t pubHandle, const char *topic, const ezmqMsgHandle_t event)
@@ -111,21 +994,115 @@ CEZMQErrorCode ezmqPublishOnTopic(ezmqPubHandle_t pubHandle, const char *topic,
     VERIFY_NON_NULL(pubHandle)
     VERIFY_NON_NULL(event)
     VERIFY_NON_NULL_TOPIC(topic)
-    EZMQPublisher *publisherObj = getPubInstance(pubHandle);
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
+    CEZMQErrorCode result = checkTopicRate(pubHandle, topic, event);
+    if (CEZMQ_OK != result)
+    {
+        return result;
+    }
+    return publishMessage(pubObj, topic, event);
+}
 
-    const ezmq::EZMQMessage *ezmqMessage = static_cast<const ezmq::EZMQMessage *>(event);
-    if(EZMQ_CONTENT_TYPE_PROTOBUF == ezmqMessage->getContentType())
+CEZMQErrorCode ezmqPublishOnTopicSet(ezmqPubHandle_t pubHandle, ezmqTopicSetHandle_t topicSet,
+        const ezmqMsgHandle_t event)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(event)
+    VERIFY_NON_NULL_TOPIC(topicSet)
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
+    const std::list<std::string> &topics = static_cast<ezmq::topicSet *>(topicSet)->topics;
+    CEZMQErrorCode result = checkRate(pubHandle, NULL, event, topics.size());
+    if (CEZMQ_OK != result)
     {
-        return CEZMQErrorCode(publisherObj->publish(topic, *(static_cast<const ezmq::Event *>(event))));
+        return result;
     }
-    else if(EZMQ_CONTENT_TYPE_BYTEDATA == ezmqMessage->getContentType())
+    return publishTo(pubObj, topics, event);
+}
+
+// Gathered data up to this size is kept per thread for next publish, larger data is freed
+// right after it is published.
+#define GATHER_BUFFER_MAX (64 * 1024)
+
+static void keepGatherBuffer(uint8_t * /*data*/, void * /*hint*/)
+{
+}
+
+CEZMQErrorCode ezmqPublishByteDataV(ezmqPubHandle_t pubHandle, const char *topic,
+        const struct iovec *iov, int iovcnt)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(iov)
+    if (iovcnt <= 0)
+    {
+        return CEZMQ_ERROR;
+    }
+    size_t length = getSegmentedLength(iov, iovcnt);
+    if (0 == length)
+    {
+        return CEZMQ_ERROR;
+    }
+    static thread_local std::vector<uint8_t> gatherBuffer;
+    std::unique_ptr<uint8_t[]> largeBuffer;
+    uint8_t *data = NULL;
+    if (length <= GATHER_BUFFER_MAX)
     {
-        return CEZMQErrorCode(publisherObj->publish(topic, *(static_cast<const ezmq::EZMQByteData *>(event))));
+        if (gatherBuffer.size() < length)
+        {
+            gatherBuffer.resize(length);
+        }
+        data = gatherBuffer.data();
     }
     else
     {
-        return CEZMQ_INVALID_CONTENT_TYPE;
+        largeBuffer.reset(new(std::nothrow) uint8_t[length]);
+        ALLOC_ASSERT(largeBuffer)
+        data = largeBuffer.get();
+    }
+    writeSegments(data, iov, iovcnt);
+
+    // Buffers are gathered once, in-process and shared memory endpoints read the gathered
+    // data in place. EZMQ takes its own copy of it for TCP socket.
+    byteDataRef byteData(data, length, keepGatherBuffer, NULL);
+    CEZMQErrorCode result = checkTopicRate(pubHandle, topic, &byteData);
+    if (CEZMQ_OK != result)
+    {
+        return result;
+    }
+    return publishMessage(static_cast<publisher *>(pubHandle), topic, &byteData);
+}
+
+CEZMQErrorCode ezmqPublishBatch(ezmqPubHandle_t pubHandle, const char **topics,
+        ezmqMsgHandle_t *events, int count, CEZMQErrorCode *results)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(events)
+    if (count <= 0)
+    {
+        return CEZMQ_ERROR;
     }
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
+    CEZMQErrorCode batchResult = CEZMQ_OK;
+    for (int i = 0; i < count; i++)
+    {
+        CEZMQErrorCode result = CEZMQ_ERROR;
+        if (events[i])
+        {
+            result = checkTopicRate(pubHandle, topics ? topics[i] : NULL, events[i]);
+            if (CEZMQ_OK == result)
+            {
+                result = publishMessage(pubObj, topics ? topics[i] : NULL, events[i]);
+            }
+        }
+        if (results)
+        {
+            results[i] = result;
+        }
+        if (CEZMQ_OK != result)
+        {
+            batchResult = CEZMQ_ERROR;
+        }
+    }
+    return batchResult;
 }
 
 CEZMQErrorCode ezmqPublishOnTopicList(ezmqPubHandle_t pubHandle, const char ** topicList,
@@ -134,7 +1111,7 @@ CEZMQErrorCode ezmqPublishOnTopicList(ezmqPubHandle_t pubHandle, const char ** t
     VERIFY_NON_NULL(pubHandle)
     VERIFY_NON_NULL(event)
     VERIFY_NON_NULL_TOPIC(topicList)
-    EZMQPublisher *publisherObj = getPubInstance(pubHandle);
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
     if (0 == listSize)
     {
         return CEZMQ_INVALID_TOPIC;
@@ -142,37 +1119,312 @@ CEZMQErrorCode ezmqPublishOnTopicList(ezmqPubHandle_t pubHandle, const char ** t
     std::list<std::string> topics;
     for (int  i =0; i < listSize; i++)
     {
+        if (!isValidTopic(topicList[i]))
+        {
+            return CEZMQ_INVALID_TOPIC;
+        }
         topics.push_back(topicList[i]);
     }
+    CEZMQErrorCode result = checkRate(pubHandle, NULL, event, listSize);
+    if (CEZMQ_OK != result)
+    {
+        return result;
+    }
+    return publishTo(pubObj, topics, event);
+}
+
+CEZMQErrorCode ezmqPublishOnTopicHandle(ezmqPubHandle_t pubHandle, ezmqTopicHandle_t topicHandle,
+        const ezmqMsgHandle_t event)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(event)
+    VERIFY_NON_NULL_TOPIC(topicHandle)
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
+    internedTopic *topicObj = static_cast<internedTopic *>(topicHandle);
+    CEZMQErrorCode result = checkRate(pubHandle, topicObj, event);
+    if (CEZMQ_OK != result)
+    {
+        return result;
+    }
+    return publishTo(pubObj, topicObj->name, event);
+}
+
+CEZMQErrorCode ezmqPublishAsync(ezmqPubHandle_t pubHandle, const char *topic, ezmqMsgHandle_t event)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(event)
+    asyncSender *sender = static_cast<publisher *>(pubHandle)->sender;
+    VERIFY_NON_NULL(sender)
+    if (topic && '\0' == topic[0])
+    {
+        return CEZMQ_INVALID_TOPIC;
+    }
+    EZMQContentType contentType = static_cast<const ezmq::EZMQMessage *>(event)->getContentType();
+    if (EZMQ_CONTENT_TYPE_PROTOBUF != contentType && EZMQ_CONTENT_TYPE_BYTEDATA != contentType)
+    {
+        return CEZMQ_INVALID_CONTENT_TYPE;
+    }
+    if (isArenaMessage(static_cast<const ezmq::EZMQMessage *>(event)))
+    {
+        return CEZMQ_ERROR;
+    }
+    queuedMessage item;
+    item.event = event;
+    item.prepared = NULL;
+    item.topicObj = NULL;
+    item.hasTopic = (NULL != topic);
+    item.conflated = false;
+    if (topic)
+    {
+        item.topic = topic;
+    }
+    return enqueueMessage(sender, item);
+}
+
+CEZMQErrorCode ezmqPublishAsyncOnTopicHandle(ezmqPubHandle_t pubHandle,
+        ezmqTopicHandle_t topicHandle, ezmqMsgHandle_t event)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(event)
+    VERIFY_NON_NULL_TOPIC(topicHandle)
+    asyncSender *sender = static_cast<publisher *>(pubHandle)->sender;
+    VERIFY_NON_NULL(sender)
+    EZMQContentType contentType = static_cast<const ezmq::EZMQMessage *>(event)->getContentType();
+    if (EZMQ_CONTENT_TYPE_PROTOBUF != contentType && EZMQ_CONTENT_TYPE_BYTEDATA != contentType)
+    {
+        return CEZMQ_INVALID_CONTENT_TYPE;
+    }
+    if (isArenaMessage(static_cast<const ezmq::EZMQMessage *>(event)))
+    {
+        return CEZMQ_ERROR;
+    }
+    internedTopic *topicObj = static_cast<internedTopic *>(topicHandle);
+    retainTopic(topicObj);
+    queuedMessage item;
+    item.event = event;
+    item.prepared = NULL;
+    item.topicObj = topicObj;
+    item.hasTopic = true;
+    item.conflated = false;
+    CEZMQErrorCode result = enqueueMessage(sender, item);
+    if (CEZMQ_OK != result)
+    {
+        releaseTopic(topicObj);
+    }
+    return result;
+}
 
+static CEZMQErrorCode createPrepared(ezmqMsgHandle_t event, ezmqPreparedMsgHandle_t *prepared)
+{
+    preparedMessage *preparedObj = new(std::nothrow) preparedMessage();
+    ALLOC_ASSERT(preparedObj)
+    preparedObj->event = event;
     const ezmq::EZMQMessage *ezmqMessage = static_cast<const ezmq::EZMQMessage *>(event);
     if(EZMQ_CONTENT_TYPE_PROTOBUF == ezmqMessage->getContentType())
     {
-        return CEZMQErrorCode(publisherObj->publish(topics, *(static_cast<const ezmq::Event *>(event))));
+        static_cast<const ezmq::Event *>(ezmqMessage)->SerializeToString(&preparedObj->serialized);
     }
-    else if(EZMQ_CONTENT_TYPE_BYTEDATA == ezmqMessage->getContentType())
+    preparedObj->refCount.store(1);
+    *prepared = preparedObj;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqCreatePreparedMessage(const ezmqMsgHandle_t event,
+        ezmqPreparedMsgHandle_t *prepared)
+{
+    VERIFY_NON_NULL(event)
+    VERIFY_NON_NULL(prepared)
+    ezmqMsgHandle_t copy = copyMessage(static_cast<const ezmq::EZMQMessage *>(event));
+    if (!copy)
+    {
+        return CEZMQ_INVALID_CONTENT_TYPE;
+    }
+    return createPrepared(copy, prepared);
+}
+
+CEZMQErrorCode ezmqEventFreeze(ezmqEventHandle_t *eventHandle, ezmqPreparedMsgHandle_t *prepared)
+{
+    VERIFY_NON_NULL(eventHandle)
+    VERIFY_NON_NULL(*eventHandle)
+    VERIFY_NON_NULL(prepared)
+    const ezmq::EZMQMessage *ezmqMessage = static_cast<const ezmq::EZMQMessage *>(*eventHandle);
+    if (isArenaMessage(ezmqMessage))
     {
-        return CEZMQErrorCode(publisherObj->publish(topics, *(static_cast<const ezmq::EZMQByteData *>(event))));
+        return CEZMQ_ERROR;
     }
-    else
+    if(EZMQ_CONTENT_TYPE_BYTEDATA == ezmqMessage->getContentType())
     {
-        return CEZMQ_INVALID_CONTENT_TYPE;
+        // Prepared message can be published from many threads, take the copy up front.
+        detachByteData(static_cast<const ezmq::EZMQByteData *>(*eventHandle));
+    }
+    createPrepared(*eventHandle, prepared);
+    *eventHandle = NULL;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqPublishPrepared(ezmqPubHandle_t pubHandle, const char *topic,
+        ezmqPreparedMsgHandle_t prepared)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(prepared)
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
+    preparedMessage *preparedObj = static_cast<preparedMessage *>(prepared);
+    CEZMQErrorCode result = checkTopicRate(pubHandle, topic, preparedObj->event);
+    if (CEZMQ_OK != result)
+    {
+        return result;
+    }
+    return publishMessage(pubObj, topic, preparedObj->event, &preparedObj->serialized);
+}
+
+CEZMQErrorCode ezmqPublishPreparedAsync(ezmqPubHandle_t pubHandle, const char *topic,
+        ezmqPreparedMsgHandle_t prepared)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(prepared)
+    asyncSender *sender = static_cast<publisher *>(pubHandle)->sender;
+    VERIFY_NON_NULL(sender)
+    if (topic && '\0' == topic[0])
+    {
+        return CEZMQ_INVALID_TOPIC;
+    }
+    preparedMessage *preparedObj = static_cast<preparedMessage *>(prepared);
+    preparedObj->refCount.fetch_add(1);
+    queuedMessage item;
+    item.event = preparedObj->event;
+    item.prepared = preparedObj;
+    item.topicObj = NULL;
+    item.hasTopic = (NULL != topic);
+    item.conflated = false;
+    if (topic)
+    {
+        item.topic = topic;
+    }
+    CEZMQErrorCode result = enqueueMessage(sender, item);
+    if (CEZMQ_OK != result)
+    {
+        preparedObj->refCount.fetch_sub(1);
+    }
+    return result;
+}
+
+CEZMQErrorCode ezmqDestroyPreparedMessage(ezmqPreparedMsgHandle_t *prepared)
+{
+    VERIFY_NON_NULL(prepared)
+    VERIFY_NON_NULL(*prepared)
+    releasePrepared(static_cast<preparedMessage *>(*prepared));
+    *prepared = NULL;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqFlushPublisher(ezmqPubHandle_t pubHandle, int timeout)
+{
+    VERIFY_NON_NULL(pubHandle)
+    if (timeout < 0)
+    {
+        return CEZMQ_ERROR;
+    }
+    asyncSender *sender = static_cast<publisher *>(pubHandle)->sender;
+    if (!sender)
+    {
+        return CEZMQ_OK;
     }
+    return flushSender(sender, timeout);
 }
 
 CEZMQErrorCode ezmqStopPublisher(ezmqPubHandle_t pubHandle)
 {
     VERIFY_NON_NULL(pubHandle)
-    EZMQPublisher *publisherObj = getPubInstance(pubHandle);
-    return CEZMQErrorCode(publisherObj->stop());
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
+    if (pubObj->sender)
+    {
+        flushSender(pubObj->sender, pubObj->sender->flushTimeout);
+        stopSender(pubObj->sender);
+    }
+    if (pubObj->bound.load())
+    {
+        unbindEndpoints(pubObj);
+    }
+    return pubObj->handle ? CEZMQErrorCode(pubObj->handle->stop()) : CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqGetPubQueueSize(ezmqPubHandle_t pubHandle, int *size)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(size)
+    asyncSender *sender = static_cast<publisher *>(pubHandle)->sender;
+    *size = sender ? sender->pending.load() : 0;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqGetPubDroppedCount(ezmqPubHandle_t pubHandle, uint64_t *count)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(count)
+    asyncSender *sender = static_cast<publisher *>(pubHandle)->sender;
+    *count = sender ? sender->dropped.load() : 0;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqSetPublisherRateLimit(ezmqPubHandle_t pubHandle, const CEZMQRateLimit *limit)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(limit)
+    getLimiter(static_cast<publisher *>(pubHandle)->limiter)->setLimit(limit->messagesPerSecond,
+            limit->messageBurst, limit->bytesPerSecond, limit->byteBurst);
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqSetTopicRateLimit(ezmqTopicHandle_t topicHandle, const CEZMQRateLimit *limit)
+{
+    VERIFY_NON_NULL(topicHandle)
+    VERIFY_NON_NULL(limit)
+    bool created = false;
+    getLimiter(static_cast<internedTopic *>(topicHandle)->limiter, &created)->setLimit(
+            limit->messagesPerSecond, limit->messageBurst, limit->bytesPerSecond, limit->byteBurst);
+    if (created)
+    {
+        addLimitedTopic();
+    }
+    return CEZMQ_OK;
+}
+
+static void getRateLimitCount(CEZMQRateLimiter *limiter, uint64_t *rejected, uint64_t *paced)
+{
+    *rejected = limiter ? limiter->mRejected.load() : 0;
+    *paced = limiter ? limiter->mPaced.load() : 0;
+}
+
+CEZMQErrorCode ezmqGetPubRateLimitCount(ezmqPubHandle_t pubHandle, uint64_t *rejected,
+        uint64_t *paced)
+{
+    VERIFY_NON_NULL(pubHandle)
+    VERIFY_NON_NULL(rejected)
+    VERIFY_NON_NULL(paced)
+    getRateLimitCount(static_cast<publisher *>(pubHandle)->limiter.load(), rejected, paced);
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqGetTopicRateLimitCount(ezmqTopicHandle_t topicHandle, uint64_t *rejected,
+        uint64_t *paced)
+{
+    VERIFY_NON_NULL(topicHandle)
+    VERIFY_NON_NULL(rejected)
+    VERIFY_NON_NULL(paced)
+    getRateLimitCount(static_cast<internedTopic *>(topicHandle)->limiter.load(), rejected, paced);
+    return CEZMQ_OK;
 }
 
 CEZMQErrorCode ezmqGetPubPort(ezmqPubHandle_t pubHandle,  int *port)
 {
     VERIFY_NON_NULL(pubHandle)
     VERIFY_NON_NULL(port)
-    EZMQPublisher *publisherObj = getPubInstance(pubHandle);
-    *port = publisherObj->getPort();
+    publisher *pubObj = static_cast<publisher *>(pubHandle);
+    if (!pubObj->handle)
+    {
+        return CEZMQ_ERROR;
+    }
+    *port = pubObj->handle->getPort();
     return CEZMQ_OK;
 }
 
@@ -180,9 +1432,22 @@ CEZMQErrorCode ezmqDestroyPublisher(ezmqPubHandle_t *pubHandle)
 {
     VERIFY_NON_NULL(pubHandle)
     VERIFY_NON_NULL(*pubHandle)
-    EZMQPublisher *publisherObj = getPubInstance(*pubHandle);
-    delete publisherObj;
     publisher *pubObj = static_cast<publisher *>(*pubHandle);
+    if (pubObj->sender)
+    {
+        stopSender(pubObj->sender);
+        delete pubObj->sender;
+    }
+    if (pubObj->bound.load())
+    {
+        unbindEndpoints(pubObj);
+    }
+    delete pubObj->handle;
+    for (size_t i = 0; i < pubObj->rings.size(); i++)
+    {
+        closeShmRing(pubObj->rings[i]);
+    }
+    delete pubObj->limiter.load();
     delete pubObj;
     *pubHandle = NULL;
     return CEZMQ_OK;
@@ -0,0 +1,177 @@
+/*******************************************************************************
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+
+/**
+ * @file   cezmqqueue.h
+ *
+ * @brief This file provides bounded lock-free multi-producer/multi-consumer queue
+ *        used internally by cezmq.
+ */
+
+#ifndef __EZMQ_QUEUE_H_INCLUDED__
+#define __EZMQ_QUEUE_H_INCLUDED__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace ezmq
+{
+    /**
+     * Bounded queue based on array of sequenced cells. Every cell carries
+     * a sequence number which tells producers and consumers whether the cell
+     * is free for writing or ready for reading, so push/pop only need a CAS
+     * on the enqueue/dequeue position.
+     *
+     * Capacity is rounded up to the next power of two.
+     */
+    template <typename T>
+    class CEZMQQueue
+    {
+        public:
+            explicit CEZMQQueue(size_t capacity)
+            {
+                mCapacity = 2;
+                while (mCapacity < capacity)
+                {
+                    mCapacity <<= 1;
+                }
+                mMask = mCapacity - 1;
+                mCells = new Cell[mCapacity];
+                for (size_t i = 0; i < mCapacity; i++)
+                {
+                    mCells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+                mEnqueuePos.store(0, std::memory_order_relaxed);
+                mDequeuePos.store(0, std::memory_order_relaxed);
+            }
+
+            ~CEZMQQueue()
+            {
+                delete[] mCells;
+            }
+
+            /**
+             * Push item at the tail of queue.
+             *
+             * @return false if queue is full, item is left untouched in that case.
+             */
+            bool push(T &item)
+            {
+                Cell *cell;
+                size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    cell = &mCells[pos & mMask];
+                    size_t seq = cell->sequence.load(std::memory_order_acquire);
+                    intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                    if (0 == diff)
+                    {
+                        if (mEnqueuePos.compare_exchange_weak(pos, pos + 1,
+                                std::memory_order_relaxed))
+                        {
+                            break;
+                        }
+                    }
+                    else if (diff < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        pos = mEnqueuePos.load(std::memory_order_relaxed);
+                    }
+                }
+                cell->data = std::move(item);
+                cell->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            /**
+             * Pop item from the head of queue.
+             *
+             * @return false if queue is empty.
+             */
+            bool pop(T &item)
+            {
+                Cell *cell;
+                size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    cell = &mCells[pos & mMask];
+                    size_t seq = cell->sequence.load(std::memory_order_acquire);
+                    intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+                    if (0 == diff)
+                    {
+                        if (mDequeuePos.compare_exchange_weak(pos, pos + 1,
+                                std::memory_order_relaxed))
+                        {
+                            break;
+                        }
+                    }
+                    else if (diff < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        pos = mDequeuePos.load(std::memory_order_relaxed);
+                    }
+                }
+                item = std::move(cell->data);
+                cell->sequence.store(pos + mMask + 1, std::memory_order_release);
+                return true;
+            }
+
+            /**
+             * Approximate number of items, exact when there is no concurrent push/pop.
+             */
+            size_t size() const
+            {
+                size_t tail = mEnqueuePos.load(std::memory_order_acquire);
+                size_t head = mDequeuePos.load(std::memory_order_acquire);
+                return (tail > head) ? (tail - head) : 0;
+            }
+
+            size_t capacity() const
+            {
+                return mCapacity;
+            }
+
+        private:
+            struct Cell
+            {
+                std::atomic<size_t> sequence;
+                T data;
+            };
+
+            CEZMQQueue(const CEZMQQueue &) = delete;
+            CEZMQQueue &operator=(const CEZMQQueue &) = delete;
+
+            Cell *mCells;
+            size_t mCapacity;
+            size_t mMask;
+            // Producers and consumers update different positions, keep them on separate cache lines.
+            char mPad0[64];
+            std::atomic<size_t> mEnqueuePos;
+            char mPad1[64 - sizeof(std::atomic<size_t>)];
+            std::atomic<size_t> mDequeuePos;
+    };
+}
+
+#endif //__EZMQ_QUEUE_H_INCLUDED__
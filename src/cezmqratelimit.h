@@ -0,0 +1,168 @@
+/*******************************************************************************
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+
+/**
+ * @file   cezmqratelimit.h
+ *
+ * @brief This file provides token bucket rate limiter used internally by cezmq.
+ */
+
+#ifndef __EZMQ_RATE_LIMIT_H_INCLUDED__
+#define __EZMQ_RATE_LIMIT_H_INCLUDED__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace ezmq
+{
+    /**
+     * Two token buckets, one counting messages and one counting bytes. Rate of 0
+     * means that dimension is not limited.
+     */
+    class CEZMQRateLimiter
+    {
+        public:
+            CEZMQRateLimiter()
+            {
+                mRejected.store(0);
+                mPaced.store(0);
+                setLimit(0, 0, 0, 0);
+            }
+
+            /**
+             * Change rates, buckets are refilled to the new burst size.
+             * Burst of 0 allows one second worth of tokens.
+             */
+            void setLimit(uint32_t messagesPerSecond, uint32_t messageBurst,
+                    uint64_t bytesPerSecond, uint64_t byteBurst)
+            {
+                std::lock_guard<std::mutex> lock(mLock);
+                mMessageRate = messagesPerSecond;
+                mMessageBurst = messageBurst ? messageBurst : messagesPerSecond;
+                mByteRate = (double) bytesPerSecond;
+                mByteBurst = (double) (byteBurst ? byteBurst : bytesPerSecond);
+                mMessageTokens = mMessageBurst;
+                mByteTokens = mByteBurst;
+                mLast = std::chrono::steady_clock::now();
+            }
+
+            bool countsBytes() const
+            {
+                std::lock_guard<std::mutex> lock(mLock);
+                return mByteRate > 0;
+            }
+
+            /**
+             * Take tokens for given number of messages of given total size.
+             *
+             * @return 0 if tokens are taken, otherwise time [in microseconds] after
+             *         which tokens will be available.
+             */
+            int64_t acquire(size_t bytes, uint32_t messages = 1)
+            {
+                std::lock_guard<std::mutex> lock(mLock);
+                if (0 == mMessageRate && 0 == mByteRate)
+                {
+                    return 0;
+                }
+                refill();
+
+                // Request bigger than burst is let through once bucket is full,
+                // bucket goes into debt for it.
+                double messageNeed = ((double) messages < mMessageBurst) ? (double) messages : mMessageBurst;
+                double byteNeed = ((double) bytes < mByteBurst) ? (double) bytes : mByteBurst;
+                double wait = 0;
+                if (mMessageRate > 0 && mMessageTokens < messageNeed)
+                {
+                    wait = (messageNeed - mMessageTokens) / mMessageRate;
+                }
+                if (mByteRate > 0 && mByteTokens < byteNeed)
+                {
+                    double byteWait = (byteNeed - mByteTokens) / mByteRate;
+                    wait = (byteWait > wait) ? byteWait : wait;
+                }
+                if (wait > 0)
+                {
+                    int64_t waitUs = (int64_t) (wait * 1000000);
+                    return waitUs > 0 ? waitUs : 1;
+                }
+                if (mMessageRate > 0)
+                {
+                    mMessageTokens -= messages;
+                }
+                if (mByteRate > 0)
+                {
+                    mByteTokens -= (double) bytes;
+                }
+                return 0;
+            }
+
+            /**
+             * Give back tokens taken by acquire for a message which is not sent.
+             */
+            void release(size_t bytes, uint32_t messages = 1)
+            {
+                std::lock_guard<std::mutex> lock(mLock);
+                if (mMessageRate > 0)
+                {
+                    mMessageTokens += messages;
+                }
+                if (mByteRate > 0)
+                {
+                    mByteTokens += (double) bytes;
+                }
+            }
+
+            std::atomic<uint64_t> mRejected;
+            std::atomic<uint64_t> mPaced;
+
+        private:
+            void refill()
+            {
+                std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                double elapsed = std::chrono::duration<double>(now - mLast).count();
+                mLast = now;
+                mMessageTokens += elapsed * mMessageRate;
+                if (mMessageTokens > mMessageBurst)
+                {
+                    mMessageTokens = mMessageBurst;
+                }
+                mByteTokens += elapsed * mByteRate;
+                if (mByteTokens > mByteBurst)
+                {
+                    mByteTokens = mByteBurst;
+                }
+            }
+
+            CEZMQRateLimiter(const CEZMQRateLimiter &) = delete;
+            CEZMQRateLimiter &operator=(const CEZMQRateLimiter &) = delete;
+
+            mutable std::mutex mLock;
+            double mMessageRate;
+            double mMessageBurst;
+            double mMessageTokens;
+            double mByteRate;
+            double mByteBurst;
+            double mByteTokens;
+            std::chrono::steady_clock::time_point mLast;
+    };
+}
+
+#endif //__EZMQ_RATE_LIMIT_H_INCLUDED__
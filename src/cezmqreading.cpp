@@ -15,10 +15,62 @@
  *
  *******************************************************************************/
 
+#include <cstring>
+
+#include <google/protobuf/unknown_field_set.h>
+
 #include "cezmqreading.h"
 #include "Event.pb.h"
 
 using namespace ezmq;
+using google::protobuf::UnknownField;
+using google::protobuf::UnknownFieldSet;
+
+// Field numbers of typed values, not yet in Reading schema of EZMQ library. Values are kept
+// as unknown fields of reading, which are serialized and parsed same as declared fields, and
+// match wire format of "oneof typed_value { double double_value = 9; int64 int64_value = 10;
+// bool bool_value = 11; bytes bytes_value = 12; }" once it is added to the schema.
+enum
+{
+    DOUBLE_VALUE_FIELD = 9,
+    INT64_VALUE_FIELD = 10,
+    BOOL_VALUE_FIELD = 11,
+    BYTES_VALUE_FIELD = 12
+};
+
+// Last typed value wins, same as parsing a oneof.
+static const UnknownField *getTypedValue(const ezmq::Reading *reading)
+{
+    const UnknownFieldSet &fields = reading->GetReflection()->GetUnknownFields(*reading);
+    for (int i = fields.field_count() - 1; i >= 0; i--)
+    {
+        int number = fields.field(i).number();
+        if (number >= DOUBLE_VALUE_FIELD && number <= BYTES_VALUE_FIELD)
+        {
+            return &fields.field(i);
+        }
+    }
+    return NULL;
+}
+
+static UnknownFieldSet *clearTypedValue(ezmqReadingHandle_t readingHandle)
+{
+    ezmq::Reading *reading = static_cast<ezmq::Reading *>(readingHandle);
+    UnknownFieldSet *fields = reading->GetReflection()->MutableUnknownFields(reading);
+    for (int number = DOUBLE_VALUE_FIELD; number <= BYTES_VALUE_FIELD; number++)
+    {
+        fields->DeleteByNumber(number);
+    }
+    return fields;
+}
+
+// Typed value of given field number and wire type.
+static const UnknownField *getTypedValue(ezmqReadingHandle_t readingHandle, int number,
+        UnknownField::Type type)
+{
+    const UnknownField *field = getTypedValue(static_cast<ezmq::Reading *>(readingHandle));
+    return (field && number == field->number() && type == field->type()) ? field : NULL;
+}
 
 CEZMQErrorCode ezmqReadingGetID(ezmqReadingHandle_t readingHandle, char **value)
 {
@@ -152,3 +204,117 @@ CEZMQErrorCode ezmqReadingSetDevice(ezmqReadingHandle_t readingHandle, const cha
     return CEZMQ_OK;
 }
 
+CEZMQErrorCode ezmqReadingSetDouble(ezmqReadingHandle_t readingHandle, double value)
+{
+    VERIFY_NON_NULL(readingHandle)
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    clearTypedValue(readingHandle)->AddFixed64(DOUBLE_VALUE_FIELD, bits);
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqReadingSetInt64(ezmqReadingHandle_t readingHandle, int64_t value)
+{
+    VERIFY_NON_NULL(readingHandle)
+    clearTypedValue(readingHandle)->AddVarint(INT64_VALUE_FIELD, static_cast<uint64_t>(value));
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqReadingSetBool(ezmqReadingHandle_t readingHandle, int value)
+{
+    VERIFY_NON_NULL(readingHandle)
+    clearTypedValue(readingHandle)->AddVarint(BOOL_VALUE_FIELD, value ? 1 : 0);
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqReadingSetBytes(ezmqReadingHandle_t readingHandle, const uint8_t *data, size_t length)
+{
+    VERIFY_NON_NULL(readingHandle)
+    if (!data && length)
+    {
+        return CEZMQ_ERROR;
+    }
+    std::string *value = clearTypedValue(readingHandle)->AddLengthDelimited(BYTES_VALUE_FIELD);
+    value->assign(reinterpret_cast<const char *>(data), length);
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqReadingGetValueType(ezmqReadingHandle_t readingHandle, CEZMQValueType *type)
+{
+    VERIFY_NON_NULL(readingHandle)
+    VERIFY_NON_NULL(type)
+    *type = CEZMQ_VALUE_STRING;
+    if (getTypedValue(readingHandle, DOUBLE_VALUE_FIELD, UnknownField::TYPE_FIXED64))
+    {
+        *type = CEZMQ_VALUE_DOUBLE;
+    }
+    else if (getTypedValue(readingHandle, INT64_VALUE_FIELD, UnknownField::TYPE_VARINT))
+    {
+        *type = CEZMQ_VALUE_INT64;
+    }
+    else if (getTypedValue(readingHandle, BOOL_VALUE_FIELD, UnknownField::TYPE_VARINT))
+    {
+        *type = CEZMQ_VALUE_BOOL;
+    }
+    else if (getTypedValue(readingHandle, BYTES_VALUE_FIELD, UnknownField::TYPE_LENGTH_DELIMITED))
+    {
+        *type = CEZMQ_VALUE_BYTES;
+    }
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqReadingGetDouble(ezmqReadingHandle_t readingHandle, double *value)
+{
+    VERIFY_NON_NULL(readingHandle)
+    VERIFY_NON_NULL(value)
+    const UnknownField *field = getTypedValue(readingHandle, DOUBLE_VALUE_FIELD, UnknownField::TYPE_FIXED64);
+    if (!field)
+    {
+        return CEZMQ_ERROR;
+    }
+    uint64_t bits = field->fixed64();
+    memcpy(value, &bits, sizeof(bits));
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqReadingGetInt64(ezmqReadingHandle_t readingHandle, int64_t *value)
+{
+    VERIFY_NON_NULL(readingHandle)
+    VERIFY_NON_NULL(value)
+    const UnknownField *field = getTypedValue(readingHandle, INT64_VALUE_FIELD, UnknownField::TYPE_VARINT);
+    if (!field)
+    {
+        return CEZMQ_ERROR;
+    }
+    *value = static_cast<int64_t>(field->varint());
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqReadingGetBool(ezmqReadingHandle_t readingHandle, int *value)
+{
+    VERIFY_NON_NULL(readingHandle)
+    VERIFY_NON_NULL(value)
+    const UnknownField *field = getTypedValue(readingHandle, BOOL_VALUE_FIELD, UnknownField::TYPE_VARINT);
+    if (!field)
+    {
+        return CEZMQ_ERROR;
+    }
+    *value = field->varint() ? 1 : 0;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqReadingGetBytes(ezmqReadingHandle_t readingHandle, const uint8_t **data, size_t *length)
+{
+    VERIFY_NON_NULL(readingHandle)
+    VERIFY_NON_NULL(data)
+    VERIFY_NON_NULL(length)
+    const UnknownField *field = getTypedValue(readingHandle, BYTES_VALUE_FIELD,
+            UnknownField::TYPE_LENGTH_DELIMITED);
+    if (!field)
+    {
+        return CEZMQ_ERROR;
+    }
+    *data = reinterpret_cast<const uint8_t *>(field->length_delimited().data());
+    *length = field->length_delimited().size();
+    return CEZMQ_OK;
+}
@@ -0,0 +1,387 @@
+/*******************************************************************************
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cezmqinternal.h"
+#include "EZMQMessage.h"
+#include "EZMQByteData.h"
+#include "Event.pb.h"
+
+#define SHM_RING_DIR "/dev/shm/cezmq-"
+#define SHM_RING_MAGIC 0x435a4d51
+#define SHM_RING_VERSION 1
+#define SHM_FLAG_TOPIC 0x01
+
+using namespace ezmq;
+
+/**
+ * Ring file layout: header followed by slotCount slots of slotSize bytes.
+ * Header and slots are placed on separate cache lines.
+ */
+typedef struct shmHeader
+{
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotSize;
+    char pad0[48];
+    // Sequence number of next event to be written.
+    std::atomic<uint64_t> head;
+    char pad1[56];
+} shmHeader;
+
+/**
+ * Slot header, followed by topic and serialized event. Sequence is 2n+1 while event n
+ * is written and 2n+2 once it is complete, so reader can detect slot being overwritten
+ * while it was reading.
+ */
+typedef struct shmSlot
+{
+    std::atomic<uint64_t> sequence;
+    uint32_t length;
+    uint8_t contentType;
+    uint8_t flags;
+    uint16_t topicLength;
+} shmSlot;
+
+struct ezmq::shmRing
+{
+    std::string path;
+    bool owner;
+    ino_t inode;
+    void *base;
+    size_t size;
+    shmHeader *header;
+    uint8_t *slots;
+    uint32_t slotCount;
+    uint32_t slotSize;
+    std::mutex writeLock;
+
+    // Reused by reader for every event.
+    Event event;
+    EZMQByteData *byteData;
+    std::string topic;
+};
+
+static shmSlot *getSlot(shmRing *ring, uint64_t sequence)
+{
+    return reinterpret_cast<shmSlot *>(ring->slots +
+            (size_t)(sequence & (ring->slotCount - 1)) * ring->slotSize);
+}
+
+static shmRing *mapShmRing(const std::string &path, int fd, size_t size, bool owner)
+{
+    void *base = mmap(NULL, size, owner ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == base)
+    {
+        return NULL;
+    }
+    shmRing *ring = new(std::nothrow) shmRing();
+    ALLOC_ASSERT(ring)
+    ring->path = path;
+    ring->owner = owner;
+    ring->base = base;
+    ring->size = size;
+    ring->header = static_cast<shmHeader *>(base);
+    ring->slots = static_cast<uint8_t *>(base) + sizeof(shmHeader);
+    ring->byteData = NULL;
+    struct stat info;
+    ring->inode = (0 == fstat(fd, &info)) ? info.st_ino : 0;
+    return ring;
+}
+
+bool ezmq::isValidShmName(const std::string &name)
+{
+    if (name.empty() || name.size() > 200)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < name.size(); i++)
+    {
+        char c = name[i];
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                '_' == c || '-' == c || '.' == c))
+        {
+            return false;
+        }
+    }
+    return name != "." && name != "..";
+}
+
+shmRing *ezmq::createShmRing(const std::string &name, uint32_t slotCount, uint32_t slotSize)
+{
+    // Slot count is power of two, slot size is multiple of cache line.
+    uint32_t count = 2;
+    while (count < slotCount)
+    {
+        count <<= 1;
+    }
+    slotSize = (slotSize + 63) & ~63u;
+    if (!isValidShmName(name) || slotSize <= sizeof(shmSlot))
+    {
+        return NULL;
+    }
+    std::string path = SHM_RING_DIR + name;
+    size_t size = sizeof(shmHeader) + (size_t) count * slotSize;
+
+    // Readers of a previous ring keep their mapping, new readers get the new file.
+    unlink(path.c_str());
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    if (0 != ftruncate(fd, size))
+    {
+        close(fd);
+        unlink(path.c_str());
+        return NULL;
+    }
+    shmRing *ring = mapShmRing(path, fd, size, true);
+    close(fd);
+    if (!ring)
+    {
+        unlink(path.c_str());
+        return NULL;
+    }
+    if (!ring->header->head.is_lock_free())
+    {
+        closeShmRing(ring);
+        return NULL;
+    }
+    ring->slotCount = count;
+    ring->slotSize = slotSize;
+    ring->header->version = SHM_RING_VERSION;
+    ring->header->slotCount = count;
+    ring->header->slotSize = slotSize;
+    ring->header->head.store(0, std::memory_order_relaxed);
+    // Pages are zero filled, so every slot sequence starts at 0 [empty].
+    ring->header->magic.store(SHM_RING_MAGIC, std::memory_order_release);
+    return ring;
+}
+
+shmRing *ezmq::openShmRing(const std::string &name)
+{
+    if (!isValidShmName(name))
+    {
+        return NULL;
+    }
+    std::string path = SHM_RING_DIR + name;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    struct stat info;
+    if (0 != fstat(fd, &info) || (size_t) info.st_size < sizeof(shmHeader))
+    {
+        close(fd);
+        return NULL;
+    }
+    shmRing *ring = mapShmRing(path, fd, info.st_size, false);
+    close(fd);
+    if (!ring)
+    {
+        return NULL;
+    }
+    shmHeader *header = ring->header;
+    if (SHM_RING_MAGIC != header->magic.load(std::memory_order_acquire) ||
+            SHM_RING_VERSION != header->version || header->slotCount < 2 ||
+            0 != (header->slotCount & (header->slotCount - 1)) || header->slotSize <= sizeof(shmSlot) ||
+            ring->size != sizeof(shmHeader) + (size_t) header->slotCount * header->slotSize)
+    {
+        closeShmRing(ring);
+        return NULL;
+    }
+    ring->slotCount = header->slotCount;
+    ring->slotSize = header->slotSize;
+    return ring;
+}
+
+void ezmq::closeShmRing(shmRing *ring)
+{
+    munmap(ring->base, ring->size);
+    if (ring->owner)
+    {
+        // Do not remove ring of a publisher which replaced this one.
+        struct stat info;
+        if (0 == stat(ring->path.c_str(), &info) && info.st_ino == ring->inode)
+        {
+            unlink(ring->path.c_str());
+        }
+    }
+    delete ring->byteData;
+    delete ring;
+}
+
+CEZMQErrorCode ezmq::writeShmRing(shmRing *ring, const std::string *topic, const EZMQMessage &event,
+        const std::string *serialized)
+{
+    size_t topicLength = topic ? topic->size() : 0;
+    size_t length = 0;
+    if (EZMQ_CONTENT_TYPE_PROTOBUF == event.getContentType())
+    {
+        length = serialized ? serialized->size() : static_cast<const Event &>(event).ByteSizeLong();
+    }
+    else if (EZMQ_CONTENT_TYPE_BYTEDATA == event.getContentType())
+    {
+        length = getByteDataLength(static_cast<const EZMQByteData *>(&event));
+    }
+    else
+    {
+        return CEZMQ_INVALID_CONTENT_TYPE;
+    }
+    if (topicLength > UINT16_MAX || sizeof(shmSlot) + topicLength + length > ring->slotSize)
+    {
+        return CEZMQ_ERROR;
+    }
+
+    std::lock_guard<std::mutex> lock(ring->writeLock);
+    uint64_t sequence = ring->header->head.load(std::memory_order_relaxed);
+    shmSlot *slot = getSlot(ring, sequence);
+    slot->sequence.store(2 * sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->length = length;
+    slot->contentType = event.getContentType();
+    slot->flags = topic ? SHM_FLAG_TOPIC : 0;
+    slot->topicLength = topicLength;
+    uint8_t *data = reinterpret_cast<uint8_t *>(slot + 1);
+    if (topicLength)
+    {
+        memcpy(data, topic->data(), topicLength);
+    }
+    if (serialized && EZMQ_CONTENT_TYPE_PROTOBUF == event.getContentType())
+    {
+        memcpy(data + topicLength, serialized->data(), length);
+    }
+    else if (EZMQ_CONTENT_TYPE_PROTOBUF == event.getContentType())
+    {
+        static_cast<const Event &>(event).SerializeToArray(data + topicLength, length);
+    }
+    else if (length)
+    {
+        byteDataView view(static_cast<const EZMQByteData *>(&event));
+        memcpy(data + topicLength, view.data(), length);
+    }
+    slot->sequence.store(2 * sequence + 2, std::memory_order_release);
+    ring->header->head.store(sequence + 1, std::memory_order_release);
+    return CEZMQ_OK;
+}
+
+uint64_t ezmq::getShmRingHead(shmRing *ring)
+{
+    return ring->header->head.load(std::memory_order_acquire);
+}
+
+/**
+ * Parse event of slot in place. Result is valid only if slot sequence is unchanged afterwards.
+ */
+static EZMQMessage *parseSlot(shmRing *ring, const shmSlot *slot)
+{
+    uint32_t length = slot->length;
+    uint16_t topicLength = slot->topicLength;
+    if (sizeof(shmSlot) + topicLength + (size_t) length > ring->slotSize)
+    {
+        return NULL;
+    }
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(slot + 1);
+    if (EZMQ_CONTENT_TYPE_PROTOBUF == slot->contentType)
+    {
+        if (!ring->event.ParseFromArray(data + topicLength, length))
+        {
+            return NULL;
+        }
+        return &ring->event;
+    }
+    if (EZMQ_CONTENT_TYPE_BYTEDATA == slot->contentType)
+    {
+        if (!ring->byteData)
+        {
+            ring->byteData = new(std::nothrow) EZMQByteData(data + topicLength, length);
+            ALLOC_ASSERT(ring->byteData)
+        }
+        else
+        {
+            ring->byteData->setByteData(data + topicLength, length);
+        }
+        return ring->byteData;
+    }
+    return NULL;
+}
+
+int ezmq::readShmRing(shmRing *ring, uint64_t &cursor, int maxEvents, inprocSubscriber *subscriberObj,
+        uint64_t &lost)
+{
+    int consumed = 0;
+    while (consumed < maxEvents)
+    {
+        uint64_t head = ring->header->head.load(std::memory_order_acquire);
+        if (cursor >= head)
+        {
+            break;
+        }
+        if (head - cursor >= ring->slotCount)
+        {
+            // Slow reader: events up to the oldest slot which is not being written are lost.
+            uint64_t oldest = head - ring->slotCount + 1;
+            lost += oldest - cursor;
+            cursor = oldest;
+        }
+        consumed++;
+        const shmSlot *slot = getSlot(ring, cursor);
+        uint64_t expected = 2 * cursor + 2;
+        cursor++;
+        if (slot->sequence.load(std::memory_order_acquire) != expected)
+        {
+            lost++;
+            continue;
+        }
+        bool hasTopic = (0 != (slot->flags & SHM_FLAG_TOPIC));
+        if (hasTopic)
+        {
+            uint16_t topicLength = slot->topicLength;
+            if (sizeof(shmSlot) + topicLength > ring->slotSize)
+            {
+                lost++;
+                continue;
+            }
+            ring->topic.assign(reinterpret_cast<const char *>(slot + 1), topicLength);
+        }
+        // Topic check before parsing, events not subscribed for are not parsed.
+        if (!isInprocSubscribed(subscriberObj, hasTopic ? &ring->topic : NULL))
+        {
+            continue;
+        }
+        EZMQMessage *event = parseSlot(ring, slot);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) != expected)
+        {
+            lost++;
+            continue;
+        }
+        if (event)
+        {
+            deliverInproc(subscriberObj, hasTopic ? &ring->topic : NULL, *event);
+        }
+    }
+    return consumed;
+}
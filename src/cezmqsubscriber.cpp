@@ -15,82 +15,1627 @@
  *
  *******************************************************************************/
 
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #include "cezmqsubscriber.h"
+#include "cezmqinternal.h"
+#include "cezmqqueue.h"
+#include "cezmqtopicpattern.h"
+#include "cezmqtopictrie.h"
 #include "EZMQSubscriber.h"
 #include "EZMQMessage.h"
 #include "EZMQByteData.h"
 #include "Event.pb.h"
 #include "EZMQException.h"
 
-using namespace ezmq;
+using namespace ezmq;
+
+typedef struct receivedMessage
+{
+    EZMQMessage *event;
+    char *topic;
+    size_t topicLength;
+} receivedMessage;
+
+typedef struct receiver
+{
+    explicit receiver(size_t queueSize) : queue(queueSize) {}
+    CEZMQQueue<receivedMessage> queue;
+    std::thread thread;
+    bool pull;
+    std::atomic<bool> running;
+    std::atomic<int> waiters;
+    std::atomic<uint64_t> dropped;
+    // Readable while events are pending, created on first ezmqGetSubscriberFd.
+    std::atomic<int> eventFd;
+    std::atomic<bool> signaled;
+    std::mutex lock;
+    std::condition_variable wakeup;
+} receiver;
+
+// Reader polls ring this many times before sleeping, so that a busy ring is read without syscalls.
+#define SHM_READ_SPIN 1000
+// Sleep of idle reader doubles from min to max, so that an idle ring costs few wakeups.
+#define SHM_READ_SLEEP_US 50
+#define SHM_READ_SLEEP_MAX_US 5000
+#define SHM_READ_BATCH 64
+
+typedef struct shmReader
+{
+    std::string name;
+    shmRing *ring;
+    uint64_t cursor;
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> lost;
+} shmReader;
+
+struct subscriber;
+
+// Event taken or retained by application. Size is counted in retain budget of subscriber
+// once the event is retained, topic is set for event taken from queue.
+typedef struct ownedMessage
+{
+    size_t size;
+    int refCount;
+    char *topic;
+} ownedMessage;
+
+// Events of subscriber owned by application, so that release frees only events given by
+// the subscriber. Events not released are freed with the subscriber.
+typedef struct ownedMessages
+{
+    std::mutex lock;
+    std::unordered_map<const EZMQMessage *, ownedMessage> messages;
+    // Bytes of retained events.
+    std::atomic<size_t> used;
+    std::atomic<size_t> limit;
+} ownedMessages;
+
+typedef struct topicRoute
+{
+    csubCBEx callback;
+    void *userData;
+} topicRoute;
+
+// Topics of subscriber used to route and filter received events.
+typedef struct topicFilter
+{
+    // Guards the tables, they are changed by subscribe APIs only.
+    std::mutex lock;
+    // Callbacks of topics subscribed using ezmqSubscribeForTopicWithCallback.
+    CEZMQTopicTrie<topicRoute> routes;
+    // Wildcard patterns, route callback is NULL for pattern given to subscriber callbacks.
+    CEZMQTopicPatterns<topicRoute> patterns;
+    // Subscribed topics and subscriptions for all events, so that events received only for
+    // the prefix subscribed for a pattern can be told apart.
+    CEZMQTopicTrie<int> topics;
+    int all;
+    // Set once there are routes or patterns, events are not looked up before.
+    std::atomic<bool> active;
+    // Set when tables are changed, snapshot is rebuilt by the next event looked up.
+    std::atomic<bool> stale;
+    // Copy of tables read by dispatching threads without lock. Readers are counted in the
+    // slot of current epoch, replaced copy is freed once the slot of its epoch drains.
+    std::atomic<const struct filterSnapshot *> snapshot;
+    std::atomic<unsigned> epoch;
+    std::atomic<int> readers[2];
+} topicFilter;
+
+// Tables of topicFilter copied under its lock, not changed afterwards.
+typedef struct filterSnapshot
+{
+    explicit filterSnapshot(const topicFilter &filter)
+        : routes(filter.routes), patterns(filter.patterns), topics(filter.topics), all(filter.all) {}
+    CEZMQTopicTrie<topicRoute> routes;
+    CEZMQTopicPatterns<topicRoute> patterns;
+    CEZMQTopicTrie<int> topics;
+    int all;
+} filterSnapshot;
+
+// Queued event being given to callback on this thread, it is retained without copy.
+static thread_local receivedMessage *gDispatching = NULL;
+
+struct subscriber;
+// Subscriber being polled by reactor on this thread, it may be stopped from its own callbacks.
+static thread_local subscriber *gPolling = NULL;
+
+// Max events of one subscriber handled in a reactor pass, so that a busy subscriber
+// does not starve others sharing the thread.
+#define REACTOR_BATCH 64
+
+typedef struct reactorThread
+{
+    std::thread thread;
+    std::atomic<bool> running;
+    // Guards members only, callbacks of a member are run with it released.
+    std::mutex membersLock;
+    std::vector<subscriber *> members;
+    // Notified under membersLock when a member is no longer polled.
+    std::condition_variable polled;
+    // Incremented on every wakeup, thread sleeps only if it is unchanged since its last pass.
+    std::atomic<uint64_t> epoch;
+    std::atomic<int> waiters;
+    std::mutex lock;
+    std::condition_variable wakeup;
+} reactorThread;
+
+typedef struct reactor
+{
+    std::vector<reactorThread *> threads;
+    std::atomic<int> subscribers;
+} reactor;
+
+typedef struct subscriber
+{
+    EZMQSubscriber *handle;
+    csubCB subCb;
+    csubTopicCB topicCb;
+    csubCBEx callbackEx;
+    void *userData;
+    receiver *recv;
+    inprocEndpoint *endpoint;
+    shmReader *reader;
+    std::shared_ptr<inprocSubscriber> local;
+    // Receive queues of dispatch threads when there are more than one, workers[0] is recv.
+    std::vector<receiver *> workers;
+    reactor *shared;
+    std::atomic<reactorThread *> worker;
+    // Set under membersLock of reactor thread while it polls the subscriber, it is not removed
+    // from reactor before cleared.
+    std::atomic<bool> polling;
+    ownedMessages *owned;
+    topicFilter *filter;
+}subscriber;
+
+// Tables are copied once after subscribe calls change them, so dispatching threads do not
+// contend on the lock for every event. Should not be called between enterSnapshot and
+// leaveSnapshot, as it waits for readers of replaced copy.
+static void refreshSnapshot(topicFilter *filter)
+{
+    if (!filter->stale.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(filter->lock);
+    if (!filter->stale.load())
+    {
+        return;
+    }
+    filterSnapshot *tables = new(std::nothrow) filterSnapshot(*filter);
+    ALLOC_ASSERT(tables)
+    const filterSnapshot *replaced = filter->snapshot.exchange(tables);
+    unsigned epoch = filter->epoch.fetch_add(1);
+    filter->stale.store(false, std::memory_order_release);
+    // Readers hold the copy only for a lookup, not while calling callbacks.
+    while (filter->readers[epoch & 1].load() > 0)
+    {
+        std::this_thread::yield();
+    }
+    delete replaced;
+}
+
+// Readers only count themselves in slot of epoch, no lock is taken. Count made after epoch
+// is advanced is undone and made again, so replaced copy is not read after its slot drains.
+static const filterSnapshot *enterSnapshot(topicFilter *filter, unsigned &epoch)
+{
+    while (true)
+    {
+        epoch = filter->epoch.load();
+        filter->readers[epoch & 1].fetch_add(1);
+        if (filter->epoch.load() == epoch)
+        {
+            return filter->snapshot.load();
+        }
+        filter->readers[epoch & 1].fetch_sub(1);
+    }
+}
+
+static void leaveSnapshot(topicFilter *filter, unsigned epoch)
+{
+    filter->readers[epoch & 1].fetch_sub(1, std::memory_order_release);
+}
+
+/**
+ * Find callback of event topic among topic callbacks and patterns, NULL route callback
+ * means subscriber callbacks.
+ *
+ * @return false if event is to be dropped, as it is received only for the prefix subscribed
+ *         for a pattern which it does not match.
+ */
+static bool routeEvent(subscriber *subObj, const char *topic, size_t topicLength, topicRoute &route)
+{
+    route.callback = NULL;
+    route.userData = NULL;
+    topicFilter *filter = subObj->filter;
+    if (!topic || !filter->active.load(std::memory_order_acquire))
+    {
+        return true;
+    }
+    refreshSnapshot(filter);
+    unsigned epoch;
+    const filterSnapshot *tables = enterSnapshot(filter, epoch);
+    const topicRoute *matched = tables->routes.match(topic, topicLength);
+    if (!matched)
+    {
+        matched = tables->patterns.match(topic, topicLength);
+    }
+    bool accepted = true;
+    if (matched)
+    {
+        route = *matched;
+    }
+    else
+    {
+        accepted = 0 == tables->patterns.size() || tables->all > 0 ||
+                tables->topics.match(topic, topicLength);
+    }
+    leaveSnapshot(filter, epoch);
+    return accepted;
+}
+
+static bool acceptTopic(subscriber *subObj, const std::string *topic)
+{
+    topicRoute route;
+    return !topic || routeEvent(subObj, topic->c_str(), topic->size(), route);
+}
+
+// Event is given to application callback without copy. Content type is checked once and event
+// is cast statically, topic is passed with its length, so nothing is allocated per event.
+static void dispatchEvent(subscriber *subObj, const char *topic, size_t topicLength,
+        const EZMQMessage &event)
+{
+    ezmqMsgHandle_t handle;
+    CEZMQContentType contentType;
+    if (EZMQ_CONTENT_TYPE_PROTOBUF == event.getContentType())
+    {
+        handle = (void *) static_cast<const Event *>(&event);
+        contentType = CEZMQ_CONTENT_TYPE_PROTOBUF;
+    }
+    else if (EZMQ_CONTENT_TYPE_BYTEDATA == event.getContentType())
+    {
+        handle = (void *) static_cast<const EZMQByteData *>(&event);
+        contentType = CEZMQ_CONTENT_TYPE_BYTEDATA;
+    }
+    else
+    {
+        return;
+    }
+    topicRoute route;
+    if (!routeEvent(subObj, topic, topicLength, route))
+    {
+        return;
+    }
+    // Size is computed only for extended callbacks, ByteSizeLong walks the whole event.
+    if (route.callback)
+    {
+        route.callback(topic, topicLength, handle, contentType, getMessageSize(&event), route.userData);
+    }
+    else if (subObj->callbackEx)
+    {
+        subObj->callbackEx(topic, topicLength, handle, contentType, getMessageSize(&event),
+                subObj->userData);
+    }
+    else if (topic)
+    {
+        subObj->topicCb(topic, handle, contentType);
+    }
+    else
+    {
+        subObj->subCb(handle, contentType);
+    }
+}
+
+static void signalEventFd(receiver *recv)
+{
+    int fd = recv->eventFd.load();
+    if (fd >= 0 && !recv->signaled.exchange(true))
+    {
+        uint64_t value = 1;
+        if (sizeof(value) != write(fd, &value, sizeof(value)))
+        {
+            recv->signaled.store(false);
+        }
+    }
+}
+
+// Called when receive queue is seen empty. Event fd is made non-readable, and signaled
+// again if an event was pushed meanwhile by a producer which saw it still signaled.
+static void clearEventFd(receiver *recv)
+{
+    int fd = recv->eventFd.load();
+    if (fd < 0 || !recv->signaled.load())
+    {
+        return;
+    }
+    uint64_t value;
+    if (sizeof(value) != read(fd, &value, sizeof(value)))
+    {
+        return;
+    }
+    recv->signaled.store(false);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (recv->queue.size() > 0)
+    {
+        signalEventFd(recv);
+    }
+}
+
+static void wakeReactor(reactorThread *worker)
+{
+    worker->epoch.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (worker->waiters.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(worker->lock);
+        worker->wakeup.notify_one();
+    }
+}
+
+static void releaseReceived(receivedMessage &item)
+{
+    if (item.event)
+    {
+        destroyMessage(item.event);
+    }
+    delete[] item.topic;
+}
+
+// Events of a topic always go to the same dispatch thread, so they are given to callback in order.
+static receiver *selectReceiver(subscriber *subObj, const std::string *topic)
+{
+    if (!topic || subObj->workers.empty())
+    {
+        return subObj->recv;
+    }
+    return subObj->workers[std::hash<std::string>()(*topic) % subObj->workers.size()];
+}
+
+// EZMQ callbacks when subscriber has receive queue: message is copied, as it is valid only
+// during the callback, and delivered to application by dispatcher thread or taken by
+// application using ezmqSubscriberReceive.
+static void queueMessage(subscriber *subObj, const std::string *topic, const EZMQMessage &event)
+{
+    if (!acceptTopic(subObj, topic))
+    {
+        return;
+    }
+    receiver *recv = selectReceiver(subObj, topic);
+    receivedMessage item;
+    item.event = copyMessage(&event);
+    if (!item.event)
+    {
+        return;
+    }
+    item.topic = NULL;
+    item.topicLength = 0;
+    if (topic)
+    {
+        item.topic = new(std::nothrow) char[topic->size() + 1];
+        ALLOC_ASSERT(item.topic)
+        memcpy(item.topic, topic->c_str(), topic->size() + 1);
+        item.topicLength = topic->size();
+    }
+    if (!recv->queue.push(item))
+    {
+        releaseReceived(item);
+        recv->dropped.fetch_add(1);
+        return;
+    }
+    signalEventFd(recv);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (recv->waiters.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(recv->lock);
+        recv->wakeup.notify_one();
+    }
+    reactorThread *worker = subObj->worker.load();
+    if (worker && !recv->pull)
+    {
+        wakeReactor(worker);
+    }
+}
+
+static void dispatchReceived(subscriber *subObj, receivedMessage &item)
+{
+    gDispatching = &item;
+    dispatchEvent(subObj, item.topic, item.topicLength, *item.event);
+    gDispatching = NULL;
+    releaseReceived(item);
+}
+
+static void dispatchLoop(subscriber *subObj, receiver *recv)
+{
+    receivedMessage item;
+    while (recv->running.load())
+    {
+        if (recv->queue.pop(item))
+        {
+            dispatchReceived(subObj, item);
+            continue;
+        }
+
+        // Same handshake as publisher sender thread, see senderLoop.
+        std::unique_lock<std::mutex> lock(recv->lock);
+        recv->waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (0 == recv->queue.size() && recv->running.load())
+        {
+            recv->wakeup.wait(lock);
+        }
+        recv->waiters.fetch_sub(1);
+    }
+}
+
+/**
+ * Take message from receive queue on application thread, waiting till timeout
+ * [in milliseconds, -1 waits till message or stop] if queue is empty.
+ */
+static CEZMQErrorCode pullMessage(receiver *recv, int timeout, receivedMessage &item)
+{
+    if (recv->queue.pop(item))
+    {
+        return CEZMQ_OK;
+    }
+    clearEventFd(recv);
+    if (recv->queue.pop(item))
+    {
+        return CEZMQ_OK;
+    }
+    if (!recv->running.load())
+    {
+        return CEZMQ_ERROR;
+    }
+    if (0 == timeout)
+    {
+        return CEZMQ_TIMEOUT;
+    }
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() +
+            std::chrono::milliseconds(timeout);
+    std::unique_lock<std::mutex> lock(recv->lock);
+    recv->waiters.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    CEZMQErrorCode result = CEZMQ_OK;
+    while (!recv->queue.pop(item))
+    {
+        if (!recv->running.load())
+        {
+            result = CEZMQ_ERROR;
+            break;
+        }
+        if (timeout < 0)
+        {
+            recv->wakeup.wait(lock);
+        }
+        else if (std::cv_status::timeout == recv->wakeup.wait_until(lock, deadline))
+        {
+            result = recv->queue.pop(item) ? CEZMQ_OK : CEZMQ_TIMEOUT;
+            break;
+        }
+    }
+    recv->waiters.fetch_sub(1);
+    return result;
+}
+
+static CEZMQContentType getContentType(const EZMQMessage *event)
+{
+    return (EZMQ_CONTENT_TYPE_PROTOBUF == event->getContentType()) ?
+            CEZMQ_CONTENT_TYPE_PROTOBUF : CEZMQ_CONTENT_TYPE_BYTEDATA;
+}
+
+static void stopReceiver(receiver *recv)
+{
+    {
+        std::lock_guard<std::mutex> lock(recv->lock);
+        recv->running.store(false);
+        recv->wakeup.notify_all();
+    }
+    if (recv->thread.joinable())
+    {
+        recv->thread.join();
+    }
+    receivedMessage item;
+    while (recv->queue.pop(item))
+    {
+        releaseReceived(item);
+        recv->dropped.fetch_add(1);
+    }
+}
+
+static EZMQSubscriber *getSubInstance(ezmqSubHandle_t subHandle)
+{
+    subscriber *subObj= static_cast<subscriber *>(subHandle);
+    return subObj->handle;
+}
+
+// Delivery from in-process publisher, on publishing thread. Event is valid only
+// during the call, same as event given by EZMQ callbacks.
+static void deliverLocal(subscriber *subObj, const std::string *topic, const EZMQMessage &event)
+{
+    if (subObj->recv)
+    {
+        queueMessage(subObj, topic, event);
+    }
+    else if (topic)
+    {
+        dispatchEvent(subObj, topic->c_str(), topic->size(), event);
+    }
+    else
+    {
+        dispatchEvent(subObj, NULL, 0, event);
+    }
+}
+
+// Counts an idle poll of shm ring. Returns time to sleep, zero while still spinning.
+static std::chrono::microseconds idleShmRead(int &idle)
+{
+    if (idle < SHM_READ_SPIN + 16)
+    {
+        idle++;
+    }
+    if (idle < SHM_READ_SPIN)
+    {
+        return std::chrono::microseconds(0);
+    }
+    long sleep = (long) SHM_READ_SLEEP_US << (idle - SHM_READ_SPIN);
+    return std::chrono::microseconds(std::min(sleep, (long) SHM_READ_SLEEP_MAX_US));
+}
+
+static void readLoop(subscriber *subObj)
+{
+    shmReader *reader = subObj->reader;
+    uint64_t lost = reader->lost.load();
+    int idle = 0;
+    while (reader->running.load(std::memory_order_relaxed))
+    {
+        if (readShmRing(reader->ring, reader->cursor, SHM_READ_BATCH, subObj->local.get(), lost) > 0)
+        {
+            reader->lost.store(lost, std::memory_order_relaxed);
+            idle = 0;
+            continue;
+        }
+        std::chrono::microseconds sleep = idleShmRead(idle);
+        if (sleep.count() > 0)
+        {
+            std::this_thread::sleep_for(sleep);
+        }
+    }
+}
+
+static CEZMQErrorCode startReader(subscriber *subObj)
+{
+    shmReader *reader = subObj->reader;
+    if (reader->ring)
+    {
+        // Restarted from own reactor callback before the ring was closed.
+        reader->running.store(true);
+        return CEZMQ_OK;
+    }
+    reader->ring = openShmRing(reader->name);
+    if (!reader->ring)
+    {
+        return CEZMQ_ERROR;
+    }
+    // Only events published after start are received.
+    reader->cursor = getShmRingHead(reader->ring);
+    reader->running.store(true);
+    if (!subObj->shared)
+    {
+        reader->thread = std::thread(readLoop, subObj);
+    }
+    return CEZMQ_OK;
+}
+
+static void stopReader(subscriber *subObj)
+{
+    shmReader *reader = subObj->reader;
+    if (!reader->ring)
+    {
+        return;
+    }
+    reader->running.store(false);
+    if (gPolling == subObj)
+    {
+        // Ring is being read by this reactor thread, it is closed once the read returns.
+        return;
+    }
+    if (reader->thread.joinable())
+    {
+        reader->thread.join();
+    }
+    closeShmRing(reader->ring);
+    reader->ring = NULL;
+}
+
+// One pass of reactor thread over a subscriber: events of its shm ring are read and queued
+// events are given to callbacks. Returns number of events handled.
+static int pollSubscriber(subscriber *subObj)
+{
+    int handled = 0;
+    shmReader *reader = subObj->reader;
+    if (reader && reader->ring)
+    {
+        uint64_t lost = reader->lost.load(std::memory_order_relaxed);
+        handled += readShmRing(reader->ring, reader->cursor, SHM_READ_BATCH, subObj->local.get(), lost);
+        reader->lost.store(lost, std::memory_order_relaxed);
+        if (!reader->running.load())
+        {
+            // Stopped from its own callback, ring was left open while being read.
+            closeShmRing(reader->ring);
+            reader->ring = NULL;
+        }
+    }
+    receiver *recv = subObj->recv;
+    if (recv && !recv->pull)
+    {
+        receivedMessage item;
+        for (int i = 0; i < REACTOR_BATCH && recv->queue.pop(item); i++)
+        {
+            dispatchReceived(subObj, item);
+            handled++;
+        }
+    }
+    return handled;
+}
+
+static void reactorLoop(reactorThread *worker)
+{
+    int idle = 0;
+    while (worker->running.load())
+    {
+        uint64_t seen = worker->epoch.load();
+        int handled = 0;
+        bool polling = false;
+        // Members removed during the pass may shift a member to next pass, it is not lost.
+        for (size_t i = 0; ; i++)
+        {
+            subscriber *member = NULL;
+            {
+                std::lock_guard<std::mutex> lock(worker->membersLock);
+                if (i >= worker->members.size())
+                {
+                    break;
+                }
+                member = worker->members[i];
+                member->polling.store(true);
+            }
+            gPolling = member;
+            polling = polling || member->reader;
+            handled += pollSubscriber(member);
+            gPolling = NULL;
+            {
+                std::lock_guard<std::mutex> lock(worker->membersLock);
+                member->polling.store(false);
+            }
+            worker->polled.notify_all();
+        }
+        if (handled > 0)
+        {
+            idle = 0;
+            continue;
+        }
+        // shm rings do not wake the thread, they are polled same as by readLoop. Queued events
+        // still wake it while it sleeps between polls.
+        std::chrono::microseconds sleep(0);
+        if (polling && 0 == (sleep = idleShmRead(idle)).count())
+        {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(worker->lock);
+        worker->waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (seen == worker->epoch.load() && worker->running.load())
+        {
+            if (polling)
+            {
+                worker->wakeup.wait_for(lock, sleep);
+            }
+            else
+            {
+                worker->wakeup.wait(lock);
+            }
+        }
+        worker->waiters.fetch_sub(1);
+    }
+}
+
+// Subscriber is added to the reactor thread having least subscribers.
+static void attachReactor(subscriber *subObj)
+{
+    if (subObj->worker.load())
+    {
+        return;
+    }
+    std::vector<reactorThread *> &threads = subObj->shared->threads;
+    reactorThread *worker = threads[0];
+    size_t count = (size_t) -1;
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        std::lock_guard<std::mutex> lock(threads[i]->membersLock);
+        if (threads[i]->members.size() < count)
+        {
+            count = threads[i]->members.size();
+            worker = threads[i];
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(worker->membersLock);
+        worker->members.push_back(subObj);
+    }
+    subObj->worker.store(worker);
+    wakeReactor(worker);
+}
+
+static void detachReactor(subscriber *subObj)
+{
+    reactorThread *worker = subObj->worker.exchange(NULL);
+    if (!worker)
+    {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(worker->membersLock);
+    for (std::vector<subscriber *>::iterator it = worker->members.begin(); it != worker->members.end(); ++it)
+    {
+        if (*it == subObj)
+        {
+            worker->members.erase(it);
+            break;
+        }
+    }
+    // Callback being run by reactor is waited for, unless subscriber is stopped from it. Removed
+    // member is not polled again, so polling is cleared at most once more.
+    if (gPolling == subObj)
+    {
+        return;
+    }
+    while (subObj->polling.load())
+    {
+        worker->polled.wait(lock);
+    }
+}
+
+/**
+ * Set callback of topic.
+ *
+ * @return true if topic had a callback, which is given in previous.
+ */
+static bool addRoute(subscriber *subObj, const char *topic, csubCBEx callback, void *userData,
+        topicRoute &previous)
+{
+    topicRoute route;
+    route.callback = callback;
+    route.userData = userData;
+    size_t length = strlen(topic);
+    std::lock_guard<std::mutex> lock(subObj->filter->lock);
+    const topicRoute *current = subObj->filter->routes.get(topic, length);
+    if (current)
+    {
+        previous = *current;
+    }
+    subObj->filter->routes.insert(topic, length, route);
+    subObj->filter->stale.store(true);
+    subObj->filter->active.store(true, std::memory_order_release);
+    return NULL != current;
+}
+
+// Callback replaced by addRoute is put back, or removed if topic had none.
+static void restoreRoute(subscriber *subObj, const char *topic, const topicRoute *previous)
+{
+    std::lock_guard<std::mutex> lock(subObj->filter->lock);
+    if (previous)
+    {
+        subObj->filter->routes.insert(topic, strlen(topic), *previous);
+    }
+    else
+    {
+        subObj->filter->routes.remove(topic, strlen(topic));
+    }
+    subObj->filter->stale.store(true);
+}
+
+/**
+ * Subscribed topics are counted, as socket keeps a subscription per subscribe call.
+ *
+ * @return false once topic is not subscribed anymore.
+ */
+static bool countTopic(CEZMQTopicTrie<int> &topics, const std::string &topic, bool subscribed)
+{
+    int *count = topics.get(topic.c_str(), topic.size());
+    if (subscribed)
+    {
+        if (count)
+        {
+            (*count)++;
+        }
+        else
+        {
+            topics.insert(topic.c_str(), topic.size(), 1);
+        }
+        return true;
+    }
+    if (count && --(*count) > 0)
+    {
+        return true;
+    }
+    if (count)
+    {
+        topics.remove(topic.c_str(), topic.size());
+    }
+    return false;
+}
+
+static void trackTopics(subscriber *subObj, const std::list<std::string> *topics, bool subscribed)
+{
+    topicFilter *filter = subObj->filter;
+    std::lock_guard<std::mutex> lock(filter->lock);
+    filter->stale.store(true);
+    if (!topics)
+    {
+        filter->all += subscribed ? 1 : (filter->all > 0 ? -1 : 0);
+        return;
+    }
+    for (std::list<std::string>::const_iterator it = topics->begin(); it != topics->end(); ++it)
+    {
+        // Callback of topic is kept till its last subscription is removed.
+        if (!countTopic(filter->topics, *it, subscribed))
+        {
+            filter->routes.remove(it->c_str(), it->size());
+        }
+    }
+}
+
+static CEZMQErrorCode trackTopic(subscriber *subObj, const char *topic, bool subscribed,
+        CEZMQErrorCode result)
+{
+    if (CEZMQ_OK == result)
+    {
+        std::list<std::string> topics;
+        if (topic)
+        {
+            topics.push_back(topic);
+        }
+        trackTopics(subObj, topic ? &topics : NULL, subscribed);
+    }
+    return result;
+}
+
+static CEZMQErrorCode trackTopics(subscriber *subObj, const std::list<std::string> &topics,
+        bool subscribed, CEZMQErrorCode result)
+{
+    if (CEZMQ_OK == result)
+    {
+        trackTopics(subObj, &topics, subscribed);
+    }
+    return result;
+}
+
+static void setLocalStarted(subscriber *subObj, bool started)
+{
+    std::lock_guard<std::recursive_mutex> lock(subObj->local->lock);
+    subObj->local->started = started;
+}
+
+// Same as EZMQ subscribe: topic is validated and subscribed as prefix, NULL topic subscribes all.
+static CEZMQErrorCode subscribeLocal(subscriber *subObj, const std::list<std::string> *topics)
+{
+    if (topics)
+    {
+        for (std::list<std::string>::const_iterator it = topics->begin(); it != topics->end(); ++it)
+        {
+            if (!isValidTopic(it->c_str()))
+            {
+                return CEZMQ_INVALID_TOPIC;
+            }
+        }
+    }
+    std::lock_guard<std::recursive_mutex> lock(subObj->local->lock);
+    if (!topics)
+    {
+        subObj->local->all++;
+        return CEZMQ_OK;
+    }
+    for (std::list<std::string>::const_iterator it = topics->begin(); it != topics->end(); ++it)
+    {
+        countTopic(subObj->local->topics, *it, true);
+    }
+    return CEZMQ_OK;
+}
+
+static CEZMQErrorCode unSubscribeLocal(subscriber *subObj, const std::list<std::string> *topics)
+{
+    if (topics)
+    {
+        for (std::list<std::string>::const_iterator it = topics->begin(); it != topics->end(); ++it)
+        {
+            if (!isValidTopic(it->c_str()))
+            {
+                return CEZMQ_INVALID_TOPIC;
+            }
+        }
+    }
+    std::lock_guard<std::recursive_mutex> lock(subObj->local->lock);
+    if (!topics)
+    {
+        if (subObj->local->all > 0)
+        {
+            subObj->local->all--;
+        }
+        return CEZMQ_OK;
+    }
+    for (std::list<std::string>::const_iterator it = topics->begin(); it != topics->end(); ++it)
+    {
+        countTopic(subObj->local->topics, *it, false);
+    }
+    return CEZMQ_OK;
+}
+
+static CEZMQErrorCode subscribeLocal(subscriber *subObj, const char *topic)
+{
+    std::list<std::string> topics(1, topic);
+    return subscribeLocal(subObj, &topics);
+}
+
+static CEZMQErrorCode unSubscribeLocal(subscriber *subObj, const char *topic)
+{
+    std::list<std::string> topics(1, topic);
+    return unSubscribeLocal(subObj, &topics);
+}
+
+// Subscribe on socket or inproc endpoint without tracking, NULL topic subscribes all.
+static CEZMQErrorCode subscribeWire(subscriber *subObj, const char *topic)
+{
+    if (!subObj->handle)
+    {
+        return topic ? subscribeLocal(subObj, topic) :
+                subscribeLocal(subObj, (std::list<std::string> *) NULL);
+    }
+    return CEZMQErrorCode(topic ? subObj->handle->subscribe(topic) : subObj->handle->subscribe());
+}
+
+static CEZMQErrorCode unSubscribeWire(subscriber *subObj, const char *topic)
+{
+    if (!subObj->handle)
+    {
+        return topic ? unSubscribeLocal(subObj, topic) :
+                unSubscribeLocal(subObj, (std::list<std::string> *) NULL);
+    }
+    return CEZMQErrorCode(topic ? subObj->handle->unSubscribe(topic) : subObj->handle->unSubscribe());
+}
+
+static topicFilter *createTopicFilter()
+{
+    topicFilter *filter = new(std::nothrow) topicFilter();
+    ALLOC_ASSERT(filter)
+    filter->all = 0;
+    filter->active.store(false);
+    filter->stale.store(true);
+    filter->snapshot.store(NULL);
+    filter->epoch.store(0);
+    filter->readers[0].store(0);
+    filter->readers[1].store(0);
+    return filter;
+}
+
+static void destroyTopicFilter(topicFilter *filter)
+{
+    delete filter->snapshot.load();
+    delete filter;
+}
+
+static ownedMessages *createOwnedMessages()
+{
+    ownedMessages *owned = new(std::nothrow) ownedMessages();
+    ALLOC_ASSERT(owned)
+    owned->used.store(0);
+    owned->limit.store(0);
+    return owned;
+}
+
+static void destroyOwnedMessages(ownedMessages *owned)
+{
+    for (std::unordered_map<const EZMQMessage *, ownedMessage>::iterator it = owned->messages.begin();
+            it != owned->messages.end(); ++it)
+    {
+        destroyMessage(const_cast<EZMQMessage *>(it->first));
+        delete[] it->second.topic;
+    }
+    delete owned;
+}
+
+// Event taken from queue by application, called with lock of owned held.
+static void addTakenMessage(ownedMessages *owned, EZMQMessage *event, char *topic)
+{
+    ownedMessage entry;
+    entry.size = 0;
+    entry.refCount = 1;
+    entry.topic = topic;
+    owned->messages[event] = entry;
+}
+
+// Count bytes of event being retained, false if budget would be exceeded.
+static bool takeRetainBudget(ownedMessages *owned, size_t size)
+{
+    size_t limit = owned->limit.load();
+    size_t used = owned->used.fetch_add(size);
+    if (limit && used + size > limit)
+    {
+        owned->used.fetch_sub(size);
+        return false;
+    }
+    return true;
+}
+
+CEZMQErrorCode ezmqCreateSubscriber(const char *ip, int port, csubCB subcb,
+        csubTopicCB topiccb, ezmqSubHandle_t *subHandle)
+ {
+    VERIFY_NON_NULL(ip)
+    if ( port < 0)
+    {
+        return CEZMQ_ERROR;
+    }
+    subscriber *subInstance = new(std::nothrow) subscriber();
+    ALLOC_ASSERT(subInstance)
+    // EZMQ gives topic by value, it is moved into the lambda and passed on without copy.
+    subInstance->handle = new(std::nothrow) EZMQSubscriber(ip, port,
+            [subInstance](const EZMQMessage &event) { dispatchEvent(subInstance, NULL, 0, event); },
+            [subInstance](std::string topic, const EZMQMessage &event)
+            {
+                dispatchEvent(subInstance, topic.c_str(), topic.size(), event);
+            });
+    ALLOC_ASSERT(subInstance->handle)
+    subInstance->subCb = subcb;
+    subInstance->topicCb = topiccb;
+    subInstance->callbackEx = NULL;
+    subInstance->userData = NULL;
+    subInstance->owned = createOwnedMessages();
+    subInstance->filter = createTopicFilter();
+    subInstance->recv = NULL;
+    subInstance->endpoint = NULL;
+    subInstance->reader = NULL;
+    subInstance->shared = NULL;
+    subInstance->worker.store(NULL);
+    subInstance->polling.store(false);
+    *subHandle = subInstance;
+    return CEZMQ_OK;
+ }
+
+static bool isPullMode(const CEZMQSubOptions *options)
+{
+    return options->version >= 2 && CEZMQ_RECEIVE_PULL == options->receiveMode;
+}
+
+static reactor *getReactor(const CEZMQSubOptions *options)
+{
+    return (options->version >= 3) ? static_cast<reactor *>(options->reactor) : NULL;
+}
+
+// Number of dispatch threads when there are more than one, otherwise 0.
+static int getDispatchThreads(const CEZMQSubOptions *options)
+{
+    return (options->version >= 4 && options->dispatchThreads > 1) ? options->dispatchThreads : 0;
+}
+
+static bool isValidSubOptions(const CEZMQSubOptions *options)
+{
+    if (options->version < 1 || options->version > CEZMQ_SUB_OPTIONS_VERSION || options->dispatchQueueSize < 0)
+    {
+        return false;
+    }
+    if (options->version >= 4 && (options->dispatchThreads < 1 ||
+            options->dispatchThreads > CEZMQ_MAX_DISPATCH_THREADS))
+    {
+        return false;
+    }
+    // Dispatch threads call callbacks of events in receive queue.
+    if (getDispatchThreads(options) && (0 == options->dispatchQueueSize || isPullMode(options) ||
+            getReactor(options)))
+    {
+        return false;
+    }
+    if (options->version >= 2 && CEZMQ_RECEIVE_CALLBACK != options->receiveMode &&
+            CEZMQ_RECEIVE_PULL != options->receiveMode)
+    {
+        return false;
+    }
+    // Pulled messages wait in receive queue.
+    return !isPullMode(options) || options->dispatchQueueSize > 0;
+}
+
+static receiver *createReceiver(int dispatchQueueSize, bool pull)
+{
+    receiver *recv = new(std::nothrow) receiver(dispatchQueueSize);
+    ALLOC_ASSERT(recv)
+    recv->pull = pull;
+    recv->running.store(false);
+    recv->waiters.store(0);
+    recv->dropped.store(0);
+    recv->eventFd.store(-1);
+    recv->signaled.store(false);
+    return recv;
+}
+
+static subscriber *createQueuedSubscriber(const CEZMQSubOptions *options, csubCB subcb,
+        csubTopicCB topiccb)
+{
+    int dispatchQueueSize = options->dispatchQueueSize;
+    subscriber *subInstance = new(std::nothrow) subscriber();
+    ALLOC_ASSERT(subInstance)
+    subInstance->handle = NULL;
+    subInstance->subCb = subcb;
+    subInstance->topicCb = topiccb;
+    subInstance->callbackEx = NULL;
+    subInstance->userData = NULL;
+    subInstance->owned = createOwnedMessages();
+    subInstance->filter = createTopicFilter();
+    subInstance->recv = NULL;
+    subInstance->endpoint = NULL;
+    subInstance->reader = NULL;
+    subInstance->shared = NULL;
+    subInstance->worker.store(NULL);
+    subInstance->polling.store(false);
+    // Queue size is split over dispatch threads, so it bounds events queued by subscriber.
+    int threads = getDispatchThreads(options);
+    if (threads > 1)
+    {
+        dispatchQueueSize = (dispatchQueueSize + threads - 1) / threads;
+    }
+    if (dispatchQueueSize > 0)
+    {
+        subInstance->recv = createReceiver(dispatchQueueSize, isPullMode(options));
+    }
+    for (int i = 0; i < threads; i++)
+    {
+        subInstance->workers.push_back(i ? createReceiver(dispatchQueueSize, false) : subInstance->recv);
+    }
+    subInstance->shared = getReactor(options);
+    if (subInstance->shared)
+    {
+        subInstance->shared->subscribers.fetch_add(1);
+    }
+    return subInstance;
+}
+
+CEZMQErrorCode ezmqInitSubOptions(CEZMQSubOptions *options, int version)
+{
+    VERIFY_NON_NULL(options)
+    if (version < 1 || version > CEZMQ_SUB_OPTIONS_VERSION)
+    {
+        return CEZMQ_ERROR;
+    }
+    options->version = version;
+    options->dispatchQueueSize = 0;
+    if (options->version >= 2)
+    {
+        options->receiveMode = CEZMQ_RECEIVE_CALLBACK;
+    }
+    if (options->version >= 3)
+    {
+        options->reactor = NULL;
+    }
+    if (options->version >= 4)
+    {
+        options->dispatchThreads = 1;
+    }
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqCreateSubscriberEx(const char *ip, int port, const CEZMQSubOptions *options,
+        csubCB subcb, csubTopicCB topiccb, ezmqSubHandle_t *subHandle)
+{
+    VERIFY_NON_NULL(ip)
+    VERIFY_NON_NULL(options)
+    VERIFY_NON_NULL(subHandle)
+    if (port < 0 || !isValidSubOptions(options))
+    {
+        return CEZMQ_ERROR;
+    }
+    if (0 == options->dispatchQueueSize)
+    {
+        // Without receive queue callbacks are called on EZMQ receiver thread.
+        if (getReactor(options))
+        {
+            return CEZMQ_ERROR;
+        }
+        return ezmqCreateSubscriber(ip, port, subcb, topiccb, subHandle);
+    }
+    subscriber *subInstance = createQueuedSubscriber(options, subcb, topiccb);
+    subInstance->handle = new(std::nothrow) EZMQSubscriber(ip, port,
+            [subInstance](const EZMQMessage &event) { queueMessage(subInstance, NULL, event); },
+            [subInstance](std::string topic, const EZMQMessage &event)
+            {
+                queueMessage(subInstance, &topic, event);
+            });
+    ALLOC_ASSERT(subInstance->handle)
+    *subHandle = subInstance;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqCreateSubscriberWithEndpoint(const char *endpoint, const CEZMQSubOptions *options,
+        csubCB subcb, csubTopicCB topiccb, ezmqSubHandle_t *subHandle)
+{
+    VERIFY_NON_NULL(subHandle)
+    std::string transport;
+    std::string address;
+    if (!parseEndpoint(endpoint, transport, address))
+    {
+        return CEZMQ_ERROR;
+    }
+    CEZMQSubOptions defaults;
+    ezmqInitSubOptions(&defaults, CEZMQ_SUB_OPTIONS_VERSION);
+    if (!options)
+    {
+        options = &defaults;
+    }
+    if ("tcp" == transport)
+    {
+        size_t separator = address.rfind(':');
+        if (std::string::npos == separator || 0 == separator)
+        {
+            return CEZMQ_ERROR;
+        }
+        char *end = NULL;
+        long port = strtol(address.c_str() + separator + 1, &end, 10);
+        if (end == address.c_str() + separator + 1 || '\0' != *end || port > 65535)
+        {
+            return CEZMQ_ERROR;
+        }
+        return ezmqCreateSubscriberEx(address.substr(0, separator).c_str(), (int) port, options,
+                subcb, topiccb, subHandle);
+    }
+    if ("inproc" != transport && ("shm" != transport || !isValidShmName(address)))
+    {
+        return CEZMQ_ERROR;
+    }
+    if (!isValidSubOptions(options))
+    {
+        return CEZMQ_ERROR;
+    }
+    if ("inproc" == transport && 0 == options->dispatchQueueSize && getReactor(options))
+    {
+        return CEZMQ_ERROR;
+    }
+    subscriber *subInstance = createQueuedSubscriber(options, subcb, topiccb);
+    subInstance->local = std::make_shared<inprocSubscriber>();
+    subInstance->local->started = false;
+    subInstance->local->all = 0;
+    subInstance->local->accept = [subInstance](const std::string *topic)
+    {
+        return acceptTopic(subInstance, topic);
+    };
+    subInstance->local->deliver = [subInstance](const std::string *topic, const EZMQMessage &event)
+    {
+        deliverLocal(subInstance, topic, event);
+    };
+    if ("shm" == transport)
+    {
+        subInstance->reader = new(std::nothrow) shmReader();
+        ALLOC_ASSERT(subInstance->reader)
+        subInstance->reader->name = address;
+        subInstance->reader->ring = NULL;
+        subInstance->reader->cursor = 0;
+        subInstance->reader->running.store(false);
+        subInstance->reader->lost.store(0);
+    }
+    else
+    {
+        subInstance->endpoint = getInprocEndpoint(address);
+        connectInprocSubscriber(subInstance->endpoint, subInstance->local);
+    }
+    *subHandle = subInstance;
+    return CEZMQ_OK;
+}
 
-typedef struct subscriber
+CEZMQErrorCode ezmqGetSubOptions(ezmqSubHandle_t subHandle, CEZMQSubOptions *options)
 {
-    EZMQSubscriber *handle;
-}subscriber;
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL(options)
+    if (options->version < 1 || options->version > CEZMQ_SUB_OPTIONS_VERSION)
+    {
+        return CEZMQ_ERROR;
+    }
+    receiver *recv = static_cast<subscriber *>(subHandle)->recv;
+    std::vector<receiver *> &workers = static_cast<subscriber *>(subHandle)->workers;
+    options->dispatchQueueSize = recv ? (int) (recv->queue.capacity() * std::max<size_t>(1, workers.size())) : 0;
+    if (options->version >= 2)
+    {
+        options->receiveMode = (recv && recv->pull) ? CEZMQ_RECEIVE_PULL : CEZMQ_RECEIVE_CALLBACK;
+    }
+    if (options->version >= 3)
+    {
+        options->reactor = static_cast<subscriber *>(subHandle)->shared;
+    }
+    if (options->version >= 4)
+    {
+        options->dispatchThreads = workers.empty() ? 1 : (int) workers.size();
+    }
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqGetSubDroppedCount(ezmqSubHandle_t subHandle, uint64_t *count)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL(count)
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    *count = subObj->recv ? subObj->recv->dropped.load() : 0;
+    for (size_t i = 1; i < subObj->workers.size(); i++)
+    {
+        *count += subObj->workers[i]->dropped.load();
+    }
+    return CEZMQ_OK;
+}
 
-void subCB(const EZMQMessage &event, csubCB subcb)
+CEZMQErrorCode ezmqSubscriberReceive(ezmqSubHandle_t subHandle, int timeout, char **topic,
+        ezmqMsgHandle_t *event, CEZMQContentType *contentType)
 {
-    if(EZMQ_CONTENT_TYPE_PROTOBUF == event.getContentType())
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL(topic)
+    VERIFY_NON_NULL(event)
+    VERIFY_NON_NULL(contentType)
+    receiver *recv = static_cast<subscriber *>(subHandle)->recv;
+    if (!recv || !recv->pull)
+    {
+        return CEZMQ_ERROR;
+    }
+    receivedMessage item;
+    CEZMQErrorCode result = pullMessage(recv, timeout, item);
+    if (CEZMQ_OK != result)
     {
-        const Event *protoEvent;
-        protoEvent =  dynamic_cast<const Event*>(&event);
-        subcb((void *)protoEvent, CEZMQ_CONTENT_TYPE_PROTOBUF);
+        return result;
     }
-    else if(EZMQ_CONTENT_TYPE_BYTEDATA == event.getContentType())
+    ownedMessages *owned = static_cast<subscriber *>(subHandle)->owned;
     {
-        const EZMQByteData *byteData;
-        byteData =  dynamic_cast<const EZMQByteData*>(&event);
-        subcb((void *)byteData, CEZMQ_CONTENT_TYPE_BYTEDATA);
+        std::lock_guard<std::mutex> lock(owned->lock);
+        addTakenMessage(owned, item.event, item.topic);
     }
+    *topic = item.topic;
+    *event = item.event;
+    *contentType = getContentType(item.event);
+    return CEZMQ_OK;
 }
 
-void subTopicCB(std::string topic, const EZMQMessage &event, csubTopicCB topiccb)
+CEZMQErrorCode ezmqSubscriberReceiveBatch(ezmqSubHandle_t subHandle, int timeout,
+        CEZMQReceivedMessage *messages, int maxCount, int *count)
 {
-    if(EZMQ_CONTENT_TYPE_PROTOBUF == event.getContentType())
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL(messages)
+    VERIFY_NON_NULL(count)
+    *count = 0;
+    receiver *recv = static_cast<subscriber *>(subHandle)->recv;
+    if (!recv || !recv->pull || maxCount <= 0)
+    {
+        return CEZMQ_ERROR;
+    }
+    receivedMessage item;
+    CEZMQErrorCode result = pullMessage(recv, timeout, item);
+    while (CEZMQ_OK == result)
     {
-        const Event *protoEvent;
-        protoEvent =  dynamic_cast<const Event*>(&event);
-        topiccb(topic.c_str(), (void *)protoEvent, CEZMQ_CONTENT_TYPE_PROTOBUF);
+        messages[*count].topic = item.topic;
+        messages[*count].event = item.event;
+        messages[*count].contentType = getContentType(item.event);
+        if (++(*count) == maxCount)
+        {
+            break;
+        }
+        if (!recv->queue.pop(item))
+        {
+            // Queue is drained, so event fd should not stay readable.
+            clearEventFd(recv);
+            break;
+        }
     }
-    else if(EZMQ_CONTENT_TYPE_BYTEDATA == event.getContentType())
+    if (*count > 0)
     {
-        const EZMQByteData *byteData;
-        byteData =  dynamic_cast<const EZMQByteData*>(&event);
-        topiccb(topic.c_str(), (void *)byteData, CEZMQ_CONTENT_TYPE_BYTEDATA);
+        ownedMessages *owned = static_cast<subscriber *>(subHandle)->owned;
+        std::lock_guard<std::mutex> lock(owned->lock);
+        for (int i = 0; i < *count; i++)
+        {
+            addTakenMessage(owned, static_cast<EZMQMessage *>(messages[i].event), messages[i].topic);
+        }
     }
+    return result;
 }
 
-static EZMQSubscriber *getSubInstance(ezmqSubHandle_t subHandle)
+CEZMQErrorCode ezmqGetSubscriberFd(ezmqSubHandle_t subHandle, int *fd)
 {
-    subscriber *subObj= static_cast<subscriber *>(subHandle);
-    return subObj->handle;
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL(fd)
+    receiver *recv = static_cast<subscriber *>(subHandle)->recv;
+    if (!recv || !recv->pull)
+    {
+        return CEZMQ_ERROR;
+    }
+    int current = recv->eventFd.load();
+    if (current < 0)
+    {
+        int created = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (created < 0)
+        {
+            return CEZMQ_ERROR;
+        }
+        if (recv->eventFd.compare_exchange_strong(current, created))
+        {
+            current = created;
+            // Events queued before fd was created.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (recv->queue.size() > 0)
+            {
+                signalEventFd(recv);
+            }
+        }
+        else
+        {
+            close(created);
+        }
+    }
+    *fd = current;
+    return CEZMQ_OK;
 }
 
-CEZMQErrorCode ezmqCreateSubscriber(const char *ip, int port, csubCB subcb,
-        csubTopicCB topiccb, ezmqSubHandle_t *subHandle)
- {
-    VERIFY_NON_NULL(ip)
-    if ( port < 0)
+CEZMQErrorCode ezmqRetainMessage(ezmqSubHandle_t subHandle, const ezmqMsgHandle_t event,
+        ezmqMsgHandle_t *retained)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL(event)
+    VERIFY_NON_NULL(retained)
+    ownedMessages *owned = static_cast<subscriber *>(subHandle)->owned;
+    const EZMQMessage *message = static_cast<const EZMQMessage *>(event);
+    size_t size = getMessageSize(message);
+    {
+        std::lock_guard<std::mutex> lock(owned->lock);
+        std::unordered_map<const EZMQMessage *, ownedMessage>::iterator it = owned->messages.find(message);
+        if (it != owned->messages.end())
+        {
+            // Taken event is counted in budget once it is retained.
+            if (0 == it->second.size)
+            {
+                if (!takeRetainBudget(owned, size))
+                {
+                    return CEZMQ_QUEUE_FULL;
+                }
+                it->second.size = size;
+            }
+            it->second.refCount++;
+            *retained = event;
+            return CEZMQ_OK;
+        }
+    }
+    if (!takeRetainBudget(owned, size))
+    {
+        return CEZMQ_QUEUE_FULL;
+    }
+
+    // Queued event is owned by this library and is taken over, event of EZMQ is copied.
+    EZMQMessage *kept = NULL;
+    if (gDispatching && gDispatching->event == message)
     {
+        kept = gDispatching->event;
+        gDispatching->event = NULL;
+    }
+    else if (!(kept = copyMessage(message)))
+    {
+        owned->used.fetch_sub(size);
         return CEZMQ_ERROR;
     }
-    EZMQSubscriber *subscriberObj = nullptr ;
-    subscriberObj = new(std::nothrow) EZMQSubscriber(ip, port,
-                                        std::bind(subCB, std::placeholders::_1,  subcb),
-                                        std::bind(subTopicCB, std::placeholders::_1, std::placeholders::_2, topiccb));
+    ownedMessage entry;
+    entry.size = size;
+    entry.refCount = 1;
+    entry.topic = NULL;
+    {
+        std::lock_guard<std::mutex> lock(owned->lock);
+        owned->messages[kept] = entry;
+    }
+    *retained = kept;
+    return CEZMQ_OK;
+}
 
-    ALLOC_ASSERT(subscriberObj)
-    subscriber *subInstance = new(std::nothrow) subscriber();
-    if(!subInstance)
+CEZMQErrorCode ezmqSetSubRetainBudget(ezmqSubHandle_t subHandle, size_t bytes)
+{
+    VERIFY_NON_NULL(subHandle)
+    static_cast<subscriber *>(subHandle)->owned->limit.store(bytes);
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqGetSubRetainedSize(ezmqSubHandle_t subHandle, size_t *bytes)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL(bytes)
+    *bytes = static_cast<subscriber *>(subHandle)->owned->used.load();
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqReleaseMessage(ezmqSubHandle_t subHandle, char **topic, ezmqMsgHandle_t *event)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL(event)
+    VERIFY_NON_NULL(*event)
+    ownedMessages *owned = static_cast<subscriber *>(subHandle)->owned;
+    EZMQMessage *message = static_cast<EZMQMessage *>(*event);
+    char *taken = NULL;
     {
-        delete subscriberObj;
-        abort();
+        std::lock_guard<std::mutex> lock(owned->lock);
+        std::unordered_map<const EZMQMessage *, ownedMessage>::iterator it = owned->messages.find(message);
+        if (it == owned->messages.end() || (topic && *topic && *topic != it->second.topic))
+        {
+            return CEZMQ_ERROR;
+        }
+        if (topic && *topic)
+        {
+            taken = it->second.topic;
+            it->second.topic = NULL;
+        }
+        if (--it->second.refCount > 0)
+        {
+            message = NULL;
+        }
+        else
+        {
+            owned->used.fetch_sub(it->second.size);
+            if (!taken)
+            {
+                taken = it->second.topic;
+            }
+            owned->messages.erase(it);
+        }
     }
-    subInstance->handle =  subscriberObj;
-    *subHandle = subInstance;
+    delete[] taken;
+    if (topic)
+    {
+        *topic = NULL;
+    }
+    if (message)
+    {
+        destroyMessage(message);
+    }
+    *event = NULL;
     return CEZMQ_OK;
- }
+}
+
+CEZMQErrorCode ezmqReleaseMessages(ezmqSubHandle_t subHandle, CEZMQReceivedMessage *messages, int count)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL(messages)
+    CEZMQErrorCode result = CEZMQ_OK;
+    for (int i = 0; i < count; i++)
+    {
+        if (messages[i].event &&
+                CEZMQ_OK != ezmqReleaseMessage(subHandle, &messages[i].topic, &messages[i].event))
+        {
+            result = CEZMQ_ERROR;
+        }
+    }
+    return result;
+}
+
+CEZMQErrorCode ezmqGetSubGapCount(ezmqSubHandle_t subHandle, uint64_t *count)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL(count)
+    shmReader *reader = static_cast<subscriber *>(subHandle)->reader;
+    *count = reader ? reader->lost.load() : 0;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqSetSubscriberCallbackEx(ezmqSubHandle_t subHandle, csubCBEx callback,
+        void *userData)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL(callback)
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    subObj->callbackEx = callback;
+    subObj->userData = userData;
+    return CEZMQ_OK;
+}
 
 CEZMQErrorCode ezmqSetClientKeys(ezmqSubHandle_t subHandle, const char *clientPrivateKey,
         const char *clientPublicKey)
@@ -99,6 +1644,10 @@ CEZMQErrorCode ezmqSetClientKeys(ezmqSubHandle_t subHandle, const char *clientPr
     VERIFY_NON_NULL(clientPrivateKey)
     VERIFY_NON_NULL(clientPublicKey)
     EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
+    if (!subscriberObj)
+    {
+        return CEZMQ_ERROR;
+    }
     EZMQErrorCode errorCode = EZMQ_ERROR;
     try
     {
@@ -116,6 +1665,10 @@ CEZMQErrorCode ezmqSetServerPublicKey(ezmqSubHandle_t subHandle, const char *key
     VERIFY_NON_NULL(subHandle)
     VERIFY_NON_NULL(key)
     EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
+    if (!subscriberObj)
+    {
+        return CEZMQ_ERROR;
+    }
     EZMQErrorCode errorCode = EZMQ_ERROR;
     try
     {
@@ -131,25 +1684,85 @@ CEZMQErrorCode ezmqSetServerPublicKey(ezmqSubHandle_t subHandle, const char *key
 CEZMQErrorCode emzqStartSubscriber(ezmqSubHandle_t subHandle)
 {
     VERIFY_NON_NULL(subHandle)
-    EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
-    return CEZMQErrorCode(subscriberObj->start());
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    CEZMQErrorCode result = CEZMQ_OK;
+    if (subObj->handle)
+    {
+        result = CEZMQErrorCode(subObj->handle->start());
+    }
+    else
+    {
+        setLocalStarted(subObj, true);
+        if (subObj->reader && CEZMQ_OK != (result = startReader(subObj)))
+        {
+            setLocalStarted(subObj, false);
+        }
+    }
+    if (CEZMQ_OK == result && subObj->recv && !subObj->recv->thread.joinable())
+    {
+        subObj->recv->running.store(true);
+        if (!subObj->recv->pull && !subObj->shared)
+        {
+            subObj->recv->thread = std::thread(dispatchLoop, subObj, subObj->recv);
+        }
+        for (size_t i = 1; i < subObj->workers.size(); i++)
+        {
+            subObj->workers[i]->running.store(true);
+            subObj->workers[i]->thread = std::thread(dispatchLoop, subObj, subObj->workers[i]);
+        }
+    }
+    if (CEZMQ_OK == result && subObj->shared)
+    {
+        attachReactor(subObj);
+    }
+    return result;
 }
 
  CEZMQErrorCode ezmqSubscribe(ezmqSubHandle_t subHandle)
  {
     VERIFY_NON_NULL(subHandle)
-    EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
-    return CEZMQErrorCode(subscriberObj->subscribe());
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    return trackTopic(subObj, NULL, true, subscribeWire(subObj, NULL));
  }
 
  CEZMQErrorCode ezmqSubscribeForTopic(ezmqSubHandle_t subHandle, const char *topic)
  {
     VERIFY_NON_NULL(subHandle)
     VERIFY_NON_NULL_TOPIC(topic)
-    EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
-    return CEZMQErrorCode(subscriberObj->subscribe(topic));
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    return trackTopic(subObj, topic, true, subscribeWire(subObj, topic));
  }
 
+CEZMQErrorCode ezmqSubscribeForTopicWithCallback(ezmqSubHandle_t subHandle, const char *topic,
+        csubCBEx callback, void *userData)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL_TOPIC(topic)
+    VERIFY_NON_NULL(callback)
+    if (!isValidTopic(topic))
+    {
+        return CEZMQ_INVALID_TOPIC;
+    }
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    topicRoute previous;
+    bool replaced = addRoute(subObj, topic, callback, userData, previous);
+    CEZMQErrorCode result = ezmqSubscribeForTopic(subHandle, topic);
+    if (CEZMQ_OK != result)
+    {
+        restoreRoute(subObj, topic, replaced ? &previous : NULL);
+    }
+    return result;
+}
+
+CEZMQErrorCode ezmqSubscribeForTopicHandle(ezmqSubHandle_t subHandle, ezmqTopicHandle_t topicHandle)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL_TOPIC(topicHandle)
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    const char *topic = static_cast<internedTopic *>(topicHandle)->name.c_str();
+    return trackTopic(subObj, topic, true, subscribeWire(subObj, topic));
+}
+
 CEZMQErrorCode ezmqSubscribeForTopicList(ezmqSubHandle_t subHandle, const char ** topicList, int listSize)
 {
     VERIFY_NON_NULL(subHandle)
@@ -164,7 +1777,27 @@ CEZMQErrorCode ezmqSubscribeForTopicList(ezmqSubHandle_t subHandle, const char *
     {
         topics.push_back(topicList[i]);
     }
-    return CEZMQErrorCode(subscriberObj->subscribe(topics));
+    if (!subscriberObj)
+    {
+        return trackTopics(static_cast<subscriber *>(subHandle), topics, true,
+                subscribeLocal(static_cast<subscriber *>(subHandle), &topics));
+    }
+    return trackTopics(static_cast<subscriber *>(subHandle), topics, true,
+            CEZMQErrorCode(subscriberObj->subscribe(topics)));
+}
+
+CEZMQErrorCode ezmqSubscribeForTopicSet(ezmqSubHandle_t subHandle, ezmqTopicSetHandle_t topicSet)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL_TOPIC(topicSet)
+    EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    const std::list<std::string> &topics = static_cast<ezmq::topicSet *>(topicSet)->topics;
+    if (!subscriberObj)
+    {
+        return trackTopics(subObj, topics, true, subscribeLocal(subObj, &topics));
+    }
+    return trackTopics(subObj, topics, true, CEZMQErrorCode(subscriberObj->subscribe(topics)));
 }
 
 CEZMQErrorCode ezmqSubscribeWithIpPort(ezmqSubHandle_t subHandle, const char *ip, const int port,
@@ -174,22 +1807,36 @@ CEZMQErrorCode ezmqSubscribeWithIpPort(ezmqSubHandle_t subHandle, const char *ip
     VERIFY_NON_NULL(ip)
     VERIFY_NON_NULL_TOPIC(topic)
     EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
-    return CEZMQErrorCode(subscriberObj->subscribe(ip, port, topic));
+    if (!subscriberObj)
+    {
+        return CEZMQ_ERROR;
+    }
+    return trackTopic(static_cast<subscriber *>(subHandle), topic, true,
+            CEZMQErrorCode(subscriberObj->subscribe(ip, port, topic)));
 }
 
 CEZMQErrorCode ezmqUnSubscribe(ezmqSubHandle_t subHandle)
 {
     VERIFY_NON_NULL(subHandle)
-    EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
-    return CEZMQErrorCode(subscriberObj->unSubscribe());
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    return trackTopic(subObj, NULL, false, unSubscribeWire(subObj, NULL));
 }
 
 CEZMQErrorCode ezmqUnSubscribeForTopic(ezmqSubHandle_t subHandle, const char *topic)
 {
     VERIFY_NON_NULL(subHandle)
     VERIFY_NON_NULL_TOPIC(topic)
-    EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
-    return CEZMQErrorCode(subscriberObj->unSubscribe(topic));
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    return trackTopic(subObj, topic, false, unSubscribeWire(subObj, topic));
+}
+
+CEZMQErrorCode ezmqUnSubscribeForTopicHandle(ezmqSubHandle_t subHandle, ezmqTopicHandle_t topicHandle)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL_TOPIC(topicHandle)
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    const char *topic = static_cast<internedTopic *>(topicHandle)->name.c_str();
+    return trackTopic(subObj, topic, false, unSubscribeWire(subObj, topic));
 }
 
 CEZMQErrorCode ezmqUnSubscribeForTopicList(ezmqSubHandle_t subHandle, const char ** topicList , int listSize)
@@ -206,14 +1853,112 @@ CEZMQErrorCode ezmqUnSubscribeForTopicList(ezmqSubHandle_t subHandle, const char
     {
         topics.push_back(topicList[i]);
     }
-    return CEZMQErrorCode(subscriberObj->unSubscribe(topics));
+    if (!subscriberObj)
+    {
+        return trackTopics(static_cast<subscriber *>(subHandle), topics, false,
+                unSubscribeLocal(static_cast<subscriber *>(subHandle), &topics));
+    }
+    return trackTopics(static_cast<subscriber *>(subHandle), topics, false,
+            CEZMQErrorCode(subscriberObj->unSubscribe(topics)));
+}
+
+CEZMQErrorCode ezmqUnSubscribeForTopicSet(ezmqSubHandle_t subHandle, ezmqTopicSetHandle_t topicSet)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL_TOPIC(topicSet)
+    EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    const std::list<std::string> &topics = static_cast<ezmq::topicSet *>(topicSet)->topics;
+    if (!subscriberObj)
+    {
+        return trackTopics(subObj, topics, false, unSubscribeLocal(subObj, &topics));
+    }
+    return trackTopics(subObj, topics, false, CEZMQErrorCode(subscriberObj->unSubscribe(topics)));
+}
+
+CEZMQErrorCode ezmqSubscribeForTopicPattern(ezmqSubHandle_t subHandle, const char *pattern,
+        csubCBEx callback, void *userData)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL_TOPIC(pattern)
+    if (!CEZMQTopicPatterns<topicRoute>::isValid(pattern))
+    {
+        return CEZMQ_INVALID_TOPIC;
+    }
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    size_t length = strlen(pattern);
+    topicRoute route;
+    route.callback = callback;
+    route.userData = userData;
+    {
+        std::lock_guard<std::mutex> lock(subObj->filter->lock);
+        if (subObj->filter->patterns.get(pattern, length))
+        {
+            subObj->filter->patterns.insert(pattern, length, route);
+            subObj->filter->stale.store(true);
+            return CEZMQ_OK;
+        }
+    }
+    std::string prefix(pattern, CEZMQTopicPatterns<topicRoute>::getPrefixLength(pattern, length));
+    CEZMQErrorCode result = subscribeWire(subObj, prefix.empty() ? NULL : prefix.c_str());
+    if (CEZMQ_OK == result)
+    {
+        std::lock_guard<std::mutex> lock(subObj->filter->lock);
+        subObj->filter->patterns.insert(pattern, length, route);
+        subObj->filter->stale.store(true);
+        subObj->filter->active.store(true, std::memory_order_release);
+    }
+    return result;
+}
+
+CEZMQErrorCode ezmqUnSubscribeForTopicPattern(ezmqSubHandle_t subHandle, const char *pattern)
+{
+    VERIFY_NON_NULL(subHandle)
+    VERIFY_NON_NULL_TOPIC(pattern)
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    size_t length = strlen(pattern);
+    {
+        std::lock_guard<std::mutex> lock(subObj->filter->lock);
+        if (!subObj->filter->patterns.remove(pattern, length))
+        {
+            return CEZMQ_INVALID_TOPIC;
+        }
+        subObj->filter->stale.store(true);
+    }
+    std::string prefix(pattern, CEZMQTopicPatterns<topicRoute>::getPrefixLength(pattern, length));
+    return unSubscribeWire(subObj, prefix.empty() ? NULL : prefix.c_str());
 }
 
 CEZMQErrorCode ezmqStopSubscriber(ezmqSubHandle_t subHandle)
  {
     VERIFY_NON_NULL(subHandle)
-    EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
-    return CEZMQErrorCode(subscriberObj->stop());
+    subscriber *subObj = static_cast<subscriber *>(subHandle);
+    CEZMQErrorCode result = CEZMQ_OK;
+    if (subObj->handle)
+    {
+        result = CEZMQErrorCode(subObj->handle->stop());
+    }
+    else
+    {
+        setLocalStarted(subObj, false);
+    }
+    if (subObj->shared)
+    {
+        detachReactor(subObj);
+    }
+    if (subObj->reader)
+    {
+        stopReader(subObj);
+    }
+    if (subObj->recv)
+    {
+        stopReceiver(subObj->recv);
+    }
+    for (size_t i = 1; i < subObj->workers.size(); i++)
+    {
+        stopReceiver(subObj->workers[i]);
+    }
+    return result;
  }
 
 CEZMQErrorCode ezmqGetSubIp(ezmqSubHandle_t subHandle, char **ip)
@@ -221,6 +1966,10 @@ CEZMQErrorCode ezmqGetSubIp(ezmqSubHandle_t subHandle, char **ip)
     VERIFY_NON_NULL(subHandle)
     VERIFY_NON_NULL(ip)
     EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
+    if (!subscriberObj)
+    {
+        return CEZMQ_ERROR;
+    }
     *ip = (char *)subscriberObj->getIp().c_str();
     return CEZMQ_OK;
 }
@@ -230,6 +1979,10 @@ CEZMQErrorCode ezmqGetSubPort(ezmqSubHandle_t subHandle, int *port)
     VERIFY_NON_NULL(subHandle)
     VERIFY_NON_NULL(port)
     EZMQSubscriber *subscriberObj = getSubInstance(subHandle);
+    if (!subscriberObj)
+    {
+        return CEZMQ_ERROR;
+    }
     *port = subscriberObj->getPort();
     return CEZMQ_OK;
 }
@@ -241,7 +1994,91 @@ CEZMQErrorCode ezmqDestroySubscriber(ezmqSubHandle_t *subHandle)
     EZMQSubscriber *subscriberObj = getSubInstance(*subHandle);
     delete subscriberObj;
     subscriber *subObj = static_cast<subscriber *>(*subHandle);
+    if (subObj->local)
+    {
+        // Publisher may still hold the subscriber, it is not delivered to once stopped.
+        if (subObj->endpoint)
+        {
+            disconnectInprocSubscriber(subObj->endpoint, subObj->local);
+        }
+        setLocalStarted(subObj, false);
+    }
+    if (subObj->shared)
+    {
+        detachReactor(subObj);
+        subObj->shared->subscribers.fetch_sub(1);
+    }
+    if (subObj->reader)
+    {
+        stopReader(subObj);
+        delete subObj->reader;
+    }
+    if (subObj->recv)
+    {
+        stopReceiver(subObj->recv);
+        if (subObj->recv->eventFd.load() >= 0)
+        {
+            close(subObj->recv->eventFd.load());
+        }
+        delete subObj->recv;
+    }
+    for (size_t i = 1; i < subObj->workers.size(); i++)
+    {
+        stopReceiver(subObj->workers[i]);
+        delete subObj->workers[i];
+    }
+    destroyOwnedMessages(subObj->owned);
+    destroyTopicFilter(subObj->filter);
     delete subObj;
     *subHandle = NULL;
     return CEZMQ_OK;
 }
+
+CEZMQErrorCode ezmqCreateReactor(int threadCount, ezmqReactorHandle_t *reactorHandle)
+{
+    VERIFY_NON_NULL(reactorHandle)
+    if (threadCount < 1 || threadCount > CEZMQ_REACTOR_MAX_THREADS)
+    {
+        return CEZMQ_ERROR;
+    }
+    reactor *reactorObj = new(std::nothrow) reactor();
+    ALLOC_ASSERT(reactorObj)
+    reactorObj->subscribers.store(0);
+    for (int i = 0; i < threadCount; i++)
+    {
+        reactorThread *worker = new(std::nothrow) reactorThread();
+        ALLOC_ASSERT(worker)
+        worker->running.store(true);
+        worker->epoch.store(0);
+        worker->waiters.store(0);
+        worker->thread = std::thread(reactorLoop, worker);
+        reactorObj->threads.push_back(worker);
+    }
+    *reactorHandle = reactorObj;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqDestroyReactor(ezmqReactorHandle_t *reactorHandle)
+{
+    VERIFY_NON_NULL(reactorHandle)
+    VERIFY_NON_NULL(*reactorHandle)
+    reactor *reactorObj = static_cast<reactor *>(*reactorHandle);
+    if (reactorObj->subscribers.load() > 0)
+    {
+        return CEZMQ_ERROR;
+    }
+    for (size_t i = 0; i < reactorObj->threads.size(); i++)
+    {
+        reactorThread *worker = reactorObj->threads[i];
+        {
+            std::lock_guard<std::mutex> lock(worker->lock);
+            worker->running.store(false);
+            worker->wakeup.notify_all();
+        }
+        worker->thread.join();
+        delete worker;
+    }
+    delete reactorObj;
+    *reactorHandle = NULL;
+    return CEZMQ_OK;
+}
@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "cezmqtopic.h"
+#include "cezmqinternal.h"
+#include "cezmqratelimit.h"
+
+using namespace ezmq;
+
+static std::mutex gTopicLock;
+static std::unordered_map<std::string, internedTopic *> gTopics;
+// Topics having rate limiter, table is looked up for topic names only if there is any.
+static std::atomic<int> gLimitedTopics(0);
+
+bool ezmq::isValidTopic(const char *name)
+{
+    if (!name || '\0' == *name)
+    {
+        return false;
+    }
+    for (const char *c = name; *c; c++)
+    {
+        if (!((*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9') ||
+                '_' == *c || '-' == *c || '.' == *c || '/' == *c))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ezmq::retainTopic(internedTopic *topicObj)
+{
+    topicObj->refCount.fetch_add(1);
+}
+
+void ezmq::releaseTopic(internedTopic *topicObj)
+{
+    // Only the last reference needs the table lock, ezmqCreateTopic may take a new
+    // reference of the same topic until it is removed from the table.
+    int count = topicObj->refCount.load();
+    while (count > 1)
+    {
+        if (topicObj->refCount.compare_exchange_weak(count, count - 1))
+        {
+            return;
+        }
+    }
+    std::lock_guard<std::mutex> lock(gTopicLock);
+    if (1 == topicObj->refCount.fetch_sub(1))
+    {
+        gTopics.erase(topicObj->name);
+        CEZMQRateLimiter *limiter = topicObj->limiter.load();
+        if (limiter)
+        {
+            gLimitedTopics.fetch_sub(1);
+            delete limiter;
+        }
+        delete topicObj;
+    }
+}
+
+void ezmq::addLimitedTopic()
+{
+    gLimitedTopics.fetch_add(1);
+}
+
+internedTopic *ezmq::findLimitedTopic(const char *name)
+{
+    if (0 == gLimitedTopics.load())
+    {
+        return NULL;
+    }
+    std::lock_guard<std::mutex> lock(gTopicLock);
+    std::unordered_map<std::string, internedTopic *>::iterator it = gTopics.find(name);
+    if (it == gTopics.end() || !it->second->limiter.load())
+    {
+        return NULL;
+    }
+    it->second->refCount.fetch_add(1);
+    return it->second;
+}
+
+CEZMQErrorCode ezmqCreateTopic(const char *topic, ezmqTopicHandle_t *topicHandle)
+{
+    VERIFY_NON_NULL_TOPIC(topic)
+    VERIFY_NON_NULL(topicHandle)
+    if (!isValidTopic(topic))
+    {
+        return CEZMQ_INVALID_TOPIC;
+    }
+    std::lock_guard<std::mutex> lock(gTopicLock);
+    std::unordered_map<std::string, ezmq::internedTopic *>::iterator it = gTopics.find(topic);
+    if (it != gTopics.end())
+    {
+        it->second->refCount.fetch_add(1);
+        *topicHandle = it->second;
+        return CEZMQ_OK;
+    }
+    ezmq::internedTopic *topicObj = new(std::nothrow) ezmq::internedTopic();
+    ALLOC_ASSERT(topicObj)
+    topicObj->name = topic;
+    topicObj->refCount.store(1);
+    topicObj->limiter.store(NULL);
+    gTopics[topicObj->name] = topicObj;
+    *topicHandle = topicObj;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqGetTopicName(ezmqTopicHandle_t topicHandle, char **topic)
+{
+    VERIFY_NON_NULL(topicHandle)
+    VERIFY_NON_NULL(topic)
+    *topic = (char *) static_cast<ezmq::internedTopic *>(topicHandle)->name.c_str();
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqDestroyTopic(ezmqTopicHandle_t *topicHandle)
+{
+    VERIFY_NON_NULL(topicHandle)
+    VERIFY_NON_NULL(*topicHandle)
+    releaseTopic(static_cast<ezmq::internedTopic *>(*topicHandle));
+    *topicHandle = NULL;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqCreateTopicSet(const char **topicList, int listSize,
+        ezmqTopicSetHandle_t *topicSet)
+{
+    VERIFY_NON_NULL_TOPIC(topicList)
+    VERIFY_NON_NULL(topicSet)
+    if (listSize <= 0)
+    {
+        return CEZMQ_INVALID_TOPIC;
+    }
+    for (int i = 0; i < listSize; i++)
+    {
+        if (!isValidTopic(topicList[i]))
+        {
+            return CEZMQ_INVALID_TOPIC;
+        }
+    }
+    ezmq::topicSet *setObj = new(std::nothrow) ezmq::topicSet();
+    ALLOC_ASSERT(setObj)
+    for (int i = 0; i < listSize; i++)
+    {
+        setObj->topics.push_back(topicList[i]);
+    }
+    *topicSet = setObj;
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqGetTopicSetSize(ezmqTopicSetHandle_t topicSet, int *size)
+{
+    VERIFY_NON_NULL(topicSet)
+    VERIFY_NON_NULL(size)
+    *size = static_cast<ezmq::topicSet *>(topicSet)->topics.size();
+    return CEZMQ_OK;
+}
+
+CEZMQErrorCode ezmqDestroyTopicSet(ezmqTopicSetHandle_t *topicSet)
+{
+    VERIFY_NON_NULL(topicSet)
+    VERIFY_NON_NULL(*topicSet)
+    delete static_cast<ezmq::topicSet *>(*topicSet);
+    *topicSet = NULL;
+    return CEZMQ_OK;
+}
@@ -0,0 +1,415 @@
+/*******************************************************************************
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+
+/**
+ * @file   cezmqtopicpattern.h
+ *
+ * @brief This file provides matcher of wildcard topic patterns used internally by cezmq.
+ */
+
+#ifndef __EZMQ_TOPIC_PATTERN_H_INCLUDED__
+#define __EZMQ_TOPIC_PATTERN_H_INCLUDED__
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ezmq
+{
+    /**
+     * Patterns compiled into a trie of topic levels ['/' separated]. Level "*" matches any
+     * one level and "#", allowed only as last level, matches any number of levels including
+     * none, so "a/#" matches "a" and "a/b/c".
+     *
+     * Lookup walks the levels of topic once per branch taken. Literal levels are preferred
+     * over "*", and "*" over "#", when more than one pattern matches.
+     */
+    template <typename T>
+    class CEZMQTopicPatterns
+    {
+        public:
+            CEZMQTopicPatterns() : mRoot(new Node()), mSize(0) {}
+
+            /**
+             * Deep copy, so that a copy can be read while the original is changed.
+             */
+            CEZMQTopicPatterns(const CEZMQTopicPatterns &other) : mRoot(copy(other.mRoot)),
+                mSize(other.mSize) {}
+
+            ~CEZMQTopicPatterns()
+            {
+                destroy(mRoot);
+            }
+
+            /**
+             * Check pattern: levels of topic characters, "*" or a last "#".
+             */
+            static bool isValid(const char *pattern)
+            {
+                if (!pattern || '\0' == *pattern)
+                {
+                    return false;
+                }
+                const char *level = pattern;
+                for (const char *c = pattern; ; c++)
+                {
+                    if ('/' != *c && '\0' != *c)
+                    {
+                        continue;
+                    }
+                    size_t length = c - level;
+                    if (isWildcard(level, length, '#') && '\0' != *c && '\0' != c[1])
+                    {
+                        return false;
+                    }
+                    if (!isWildcard(level, length, '#') && !isWildcard(level, length, '*'))
+                    {
+                        for (const char *l = level; l < c; l++)
+                        {
+                            if (!((*l >= 'a' && *l <= 'z') || (*l >= 'A' && *l <= 'Z') ||
+                                    (*l >= '0' && *l <= '9') || '_' == *l || '-' == *l || '.' == *l))
+                            {
+                                return false;
+                            }
+                        }
+                    }
+                    if ('\0' == *c)
+                    {
+                        return true;
+                    }
+                    level = c + 1;
+                }
+            }
+
+            /**
+             * Length of the literal levels before first wildcard, without trailing '/'.
+             * Every topic matching the pattern starts with them.
+             */
+            static size_t getPrefixLength(const char *pattern, size_t length)
+            {
+                length = trim(pattern, length);
+                size_t prefix = 0;
+                size_t begin = 0;
+                while (begin <= length)
+                {
+                    size_t end = levelEnd(pattern, length, begin);
+                    if (isWildcard(pattern + begin, end - begin, '*') ||
+                            isWildcard(pattern + begin, end - begin, '#'))
+                    {
+                        break;
+                    }
+                    prefix = end;
+                    begin = end + 1;
+                }
+                return prefix;
+            }
+
+            /**
+             * Set value of pattern, replacing value inserted before. Pattern should be valid.
+             */
+            void insert(const char *pattern, size_t length, const T &value)
+            {
+                length = trim(pattern, length);
+                Node *node = mRoot;
+                for (size_t begin = 0; begin <= length; )
+                {
+                    size_t end = levelEnd(pattern, length, begin);
+                    const char *level = pattern + begin;
+                    if (isWildcard(level, end - begin, '#'))
+                    {
+                        if (!node->hasRest)
+                        {
+                            mSize++;
+                        }
+                        node->hasRest = true;
+                        node->restValue = value;
+                        return;
+                    }
+                    if (isWildcard(level, end - begin, '*'))
+                    {
+                        if (!node->star)
+                        {
+                            node->star = new Node();
+                        }
+                        node = node->star;
+                    }
+                    else
+                    {
+                        size_t index = lowerBound(node, level, end - begin);
+                        if (index == node->children.size() ||
+                                0 != compareLevel(node->children[index].first, level, end - begin))
+                        {
+                            node->children.insert(node->children.begin() + index,
+                                    std::make_pair(std::string(level, end - begin), new Node()));
+                        }
+                        node = node->children[index].second;
+                    }
+                    begin = end + 1;
+                }
+                if (!node->hasValue)
+                {
+                    mSize++;
+                }
+                node->hasValue = true;
+                node->value = value;
+            }
+
+            /**
+             * Value of given pattern.
+             *
+             * @return NULL if pattern is not inserted.
+             */
+            const T *get(const char *pattern, size_t length) const
+            {
+                std::vector<Node *> path;
+                bool rest = false;
+                if (!findPath(pattern, length, path, rest))
+                {
+                    return NULL;
+                }
+                return rest ? &path.back()->restValue : &path.back()->value;
+            }
+
+            /**
+             * Remove pattern, nodes left empty are freed.
+             *
+             * @return false if pattern is not inserted.
+             */
+            bool remove(const char *pattern, size_t length)
+            {
+                std::vector<Node *> path;
+                bool rest = false;
+                if (!findPath(pattern, length, path, rest))
+                {
+                    return false;
+                }
+                Node *node = path.back();
+                if (rest)
+                {
+                    node->hasRest = false;
+                    node->restValue = T();
+                }
+                else
+                {
+                    node->hasValue = false;
+                    node->value = T();
+                }
+                mSize--;
+                for (size_t i = path.size() - 1; i > 0 && isEmpty(path[i]); i--)
+                {
+                    Node *parent = path[i - 1];
+                    if (parent->star == path[i])
+                    {
+                        parent->star = NULL;
+                    }
+                    else
+                    {
+                        for (size_t j = 0; j < parent->children.size(); j++)
+                        {
+                            if (parent->children[j].second == path[i])
+                            {
+                                parent->children.erase(parent->children.begin() + j);
+                                break;
+                            }
+                        }
+                    }
+                    delete path[i];
+                }
+                return true;
+            }
+
+            /**
+             * Value of pattern matching given topic.
+             *
+             * @return NULL if no pattern matches.
+             */
+            const T *match(const char *topic, size_t length) const
+            {
+                length = trim(topic, length);
+                return matchFrom(mRoot, topic, length, 0);
+            }
+
+            size_t size() const
+            {
+                return mSize;
+            }
+
+        private:
+            struct Node
+            {
+                Node() : star(NULL), hasValue(false), value(), hasRest(false), restValue() {}
+                // Literal levels, sorted for binary search.
+                std::vector<std::pair<std::string, Node *> > children;
+                Node *star;
+                bool hasValue;
+                T value;
+                bool hasRest;
+                T restValue;
+            };
+
+            static bool isWildcard(const char *level, size_t length, char wildcard)
+            {
+                return 1 == length && wildcard == level[0];
+            }
+
+            static size_t trim(const char *topic, size_t length)
+            {
+                return (length > 0 && '/' == topic[length - 1]) ? length - 1 : length;
+            }
+
+            static size_t levelEnd(const char *topic, size_t length, size_t begin)
+            {
+                size_t end = begin;
+                while (end < length && '/' != topic[end])
+                {
+                    end++;
+                }
+                return end;
+            }
+
+            static bool isEmpty(const Node *node)
+            {
+                return !node->hasValue && !node->hasRest && !node->star && node->children.empty();
+            }
+
+            // Levels are ordered by length first, most levels differ in length or first bytes.
+            static int compareLevel(const std::string &name, const char *level, size_t length)
+            {
+                if (name.size() != length)
+                {
+                    return name.size() < length ? -1 : 1;
+                }
+                return memcmp(name.data(), level, length);
+            }
+
+            static size_t lowerBound(const Node *node, const char *level, size_t length)
+            {
+                size_t low = 0;
+                size_t high = node->children.size();
+                while (low < high)
+                {
+                    size_t middle = (low + high) / 2;
+                    if (compareLevel(node->children[middle].first, level, length) < 0)
+                    {
+                        low = middle + 1;
+                    }
+                    else
+                    {
+                        high = middle;
+                    }
+                }
+                return low;
+            }
+
+            static Node *findChild(const Node *node, const char *level, size_t length)
+            {
+                size_t index = lowerBound(node, level, length);
+                if (index < node->children.size() &&
+                        0 == compareLevel(node->children[index].first, level, length))
+                {
+                    return node->children[index].second;
+                }
+                return NULL;
+            }
+
+            // Nodes from root to the node of pattern, rest tells pattern ends with "#".
+            bool findPath(const char *pattern, size_t length, std::vector<Node *> &path, bool &rest) const
+            {
+                length = trim(pattern, length);
+                path.assign(1, mRoot);
+                for (size_t begin = 0; begin <= length; )
+                {
+                    size_t end = levelEnd(pattern, length, begin);
+                    const char *level = pattern + begin;
+                    if (isWildcard(level, end - begin, '#'))
+                    {
+                        rest = true;
+                        break;
+                    }
+                    Node *child = isWildcard(level, end - begin, '*') ? path.back()->star :
+                            findChild(path.back(), level, end - begin);
+                    if (!child)
+                    {
+                        return false;
+                    }
+                    path.push_back(child);
+                    begin = end + 1;
+                }
+                return rest ? path.back()->hasRest : path.back()->hasValue;
+            }
+
+            // begin is start of next level of topic, past length once all levels are matched.
+            const T *matchFrom(const Node *node, const char *topic, size_t length, size_t begin) const
+            {
+                if (begin > length)
+                {
+                    return node->hasValue ? &node->value : (node->hasRest ? &node->restValue : NULL);
+                }
+                size_t end = levelEnd(topic, length, begin);
+                const T *found = NULL;
+                const Node *child = findChild(node, topic + begin, end - begin);
+                if (child && (found = matchFrom(child, topic, length, end + 1)))
+                {
+                    return found;
+                }
+                if (node->star && (found = matchFrom(node->star, topic, length, end + 1)))
+                {
+                    return found;
+                }
+                return node->hasRest ? &node->restValue : NULL;
+            }
+
+            static Node *copy(const Node *node)
+            {
+                Node *copied = new Node();
+                copied->star = node->star ? copy(node->star) : NULL;
+                copied->hasValue = node->hasValue;
+                copied->value = node->value;
+                copied->hasRest = node->hasRest;
+                copied->restValue = node->restValue;
+                copied->children.reserve(node->children.size());
+                for (size_t i = 0; i < node->children.size(); i++)
+                {
+                    copied->children.push_back(std::make_pair(node->children[i].first,
+                            copy(node->children[i].second)));
+                }
+                return copied;
+            }
+
+            static void destroy(Node *node)
+            {
+                for (size_t i = 0; i < node->children.size(); i++)
+                {
+                    destroy(node->children[i].second);
+                }
+                if (node->star)
+                {
+                    destroy(node->star);
+                }
+                delete node;
+            }
+
+            CEZMQTopicPatterns &operator=(const CEZMQTopicPatterns &) = delete;
+
+            Node *mRoot;
+            size_t mSize;
+    };
+}
+
+#endif //__EZMQ_TOPIC_PATTERN_H_INCLUDED__
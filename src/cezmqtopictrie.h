@@ -0,0 +1,229 @@
+/*******************************************************************************
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+
+/**
+ * @file   cezmqtopictrie.h
+ *
+ * @brief This file provides prefix trie of topics used internally by cezmq for
+ *        routing received events.
+ */
+
+#ifndef __EZMQ_TOPIC_TRIE_H_INCLUDED__
+#define __EZMQ_TOPIC_TRIE_H_INCLUDED__
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ezmq
+{
+    /**
+     * Character trie mapping topics to values. Topic matches every inserted topic which is
+     * its prefix ending at a '/' boundary, same as subscription. Lookup walks the trie
+     * once along the topic, so it costs O(topic length) however many topics are inserted.
+     *
+     * Trailing '/' of inserted topic is ignored, "a/b/" and "a/b" are the same topic.
+     */
+    template <typename T>
+    class CEZMQTopicTrie
+    {
+        public:
+            CEZMQTopicTrie() : mRoot(new Node()), mSize(0) {}
+
+            /**
+             * Deep copy, so that a copy can be read while the original is changed.
+             */
+            CEZMQTopicTrie(const CEZMQTopicTrie &other) : mRoot(copy(other.mRoot)), mSize(other.mSize) {}
+
+            ~CEZMQTopicTrie()
+            {
+                destroy(mRoot);
+            }
+
+            /**
+             * Set value of topic, replacing value inserted before.
+             */
+            void insert(const char *topic, size_t length, const T &value)
+            {
+                length = trim(topic, length);
+                Node *node = mRoot;
+                for (size_t i = 0; i < length; i++)
+                {
+                    Node *child = find(node, topic[i]);
+                    if (!child)
+                    {
+                        child = new Node();
+                        node->children.push_back(std::make_pair(topic[i], child));
+                    }
+                    node = child;
+                }
+                if (!node->hasValue)
+                {
+                    mSize++;
+                }
+                node->hasValue = true;
+                node->value = value;
+            }
+
+            /**
+             * Remove value of topic, nodes left without value or children are freed.
+             *
+             * @return false if topic is not inserted.
+             */
+            bool remove(const char *topic, size_t length)
+            {
+                length = trim(topic, length);
+                std::vector<Node *> path(1, mRoot);
+                for (size_t i = 0; i < length; i++)
+                {
+                    Node *child = find(path.back(), topic[i]);
+                    if (!child)
+                    {
+                        return false;
+                    }
+                    path.push_back(child);
+                }
+                if (!path.back()->hasValue)
+                {
+                    return false;
+                }
+                path.back()->hasValue = false;
+                path.back()->value = T();
+                mSize--;
+                for (size_t i = length; i > 0 && !path[i]->hasValue && path[i]->children.empty(); i--)
+                {
+                    erase(path[i - 1], topic[i - 1]);
+                    delete path[i];
+                }
+                return true;
+            }
+
+            /**
+             * Value of given topic.
+             *
+             * @return NULL if topic is not inserted.
+             */
+            T *get(const char *topic, size_t length)
+            {
+                length = trim(topic, length);
+                Node *node = mRoot;
+                for (size_t i = 0; i < length && node; i++)
+                {
+                    node = find(node, topic[i]);
+                }
+                return (node && node->hasValue) ? &node->value : NULL;
+            }
+
+            /**
+             * Value of the longest inserted topic matching given topic.
+             *
+             * @return NULL if no inserted topic matches.
+             */
+            const T *match(const char *topic, size_t length) const
+            {
+                const T *matched = NULL;
+                const Node *node = mRoot;
+                for (size_t i = 0; node; i++)
+                {
+                    if (node->hasValue && (i == length || '/' == topic[i]))
+                    {
+                        matched = &node->value;
+                    }
+                    if (i == length)
+                    {
+                        break;
+                    }
+                    node = find(node, topic[i]);
+                }
+                return matched;
+            }
+
+            size_t size() const
+            {
+                return mSize;
+            }
+
+        private:
+            struct Node
+            {
+                Node() : hasValue(false), value() {}
+                // Topic characters are few, linear search of a small vector beats a map.
+                std::vector<std::pair<char, Node *> > children;
+                bool hasValue;
+                T value;
+            };
+
+            static size_t trim(const char *topic, size_t length)
+            {
+                return (length > 0 && '/' == topic[length - 1]) ? length - 1 : length;
+            }
+
+            static Node *find(const Node *node, char c)
+            {
+                for (size_t i = 0; i < node->children.size(); i++)
+                {
+                    if (c == node->children[i].first)
+                    {
+                        return node->children[i].second;
+                    }
+                }
+                return NULL;
+            }
+
+            static void erase(Node *node, char c)
+            {
+                for (size_t i = 0; i < node->children.size(); i++)
+                {
+                    if (c == node->children[i].first)
+                    {
+                        node->children.erase(node->children.begin() + i);
+                        return;
+                    }
+                }
+            }
+
+            static Node *copy(const Node *node)
+            {
+                Node *copied = new Node();
+                copied->hasValue = node->hasValue;
+                copied->value = node->value;
+                copied->children.reserve(node->children.size());
+                for (size_t i = 0; i < node->children.size(); i++)
+                {
+                    copied->children.push_back(std::make_pair(node->children[i].first,
+                            copy(node->children[i].second)));
+                }
+                return copied;
+            }
+
+            static void destroy(Node *node)
+            {
+                for (size_t i = 0; i < node->children.size(); i++)
+                {
+                    destroy(node->children[i].second);
+                }
+                delete node;
+            }
+
+            CEZMQTopicTrie &operator=(const CEZMQTopicTrie &) = delete;
+
+            Node *mRoot;
+            size_t mSize;
+    };
+}
+
+#endif //__EZMQ_TOPIC_TRIE_H_INCLUDED__
@@ -24,3 +24,6 @@ export LD_LIBRARY_PATH=$PWD/../../../../../dependencies/protocol-ezmq-cpp/out/li
 #cezmq_bytedata_test
 ./cezmq_bytedata_test
 
+
+#cezmq_topic_test
+./cezmq_topic_test
@@ -20,6 +20,15 @@
 #include "cezmqapi.h"
 #include "cezmqerrorcodes.h"
 
+static int freeCount;
+
+static void freeByteData(uint8_t *data, void *hint)
+{
+    EXPECT_EQ((void *)data, hint);
+    delete[] data;
+    freeCount++;
+}
+
 class CEZMQByteDataTest: public TestWithMock
 {
 protected:
@@ -47,6 +56,28 @@ TEST_F(CEZMQByteDataTest, constructByteData)
     ASSERT_EQ(CEZMQ_OK, result);
 }
 
+TEST_F(CEZMQByteDataTest, constructByteDataNoCopy)
+{
+    freeCount = 0;
+    uint8_t *buffer = new uint8_t[5] { 0x40, 0x05, 0x10, 0x11, 0x12 };
+    CEZMQErrorCode result = ezmqCreateLocalByteDataNoCopy(&mByteDataHandle, buffer, 5,
+                                                          freeByteData, buffer);
+    ASSERT_EQ(CEZMQ_OK, result);
+    uint8_t *data;
+    size_t size;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetByteData(mByteDataHandle, &data));
+    EXPECT_EQ(buffer, data);
+    EXPECT_EQ(CEZMQ_OK, ezmqGetDataLength(mByteDataHandle, &size));
+    EXPECT_EQ(5u, size);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyByteData(&mByteDataHandle));
+    EXPECT_EQ(1, freeCount);
+
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateLocalByteDataNoCopy(&mByteDataHandle, buffer, 5, NULL, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateLocalByteDataNoCopy(&mByteDataHandle, NULL, 5, freeByteData, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateLocalByteDataNoCopy(NULL, buffer, 5, freeByteData, NULL));
+    mByteDataHandle = NULL;
+}
+
 TEST_F(CEZMQByteDataTest, getEzmqByteData)
 {
     mByteDataHandle = getezmqByteData();
@@ -93,3 +124,27 @@ TEST_F(CEZMQByteDataTest, destroyNullByteData)
     mByteDataHandle = NULL;
 }
 
+TEST_F(CEZMQByteDataTest, getByteDataSegments)
+{
+    // Two segments [count, lengths in network byte order] of 2 and 1 bytes.
+    uint8_t data[] = { 0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 1, 0x40, 0x05, 0x10 };
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateByteData(&mByteDataHandle, data, sizeof(data)));
+    struct iovec segments[2];
+    int count = 1;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetByteDataSegments(mByteDataHandle, segments, &count));
+    EXPECT_EQ(2, count);
+    EXPECT_EQ(CEZMQ_OK, ezmqGetByteDataSegments(mByteDataHandle, segments, &count));
+    EXPECT_EQ(2, count);
+    EXPECT_EQ(2u, segments[0].iov_len);
+    EXPECT_EQ(0x40, static_cast<uint8_t *>(segments[0].iov_base)[0]);
+    EXPECT_EQ(1u, segments[1].iov_len);
+    EXPECT_EQ(0x10, static_cast<uint8_t *>(segments[1].iov_base)[0]);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyByteData(&mByteDataHandle));
+
+    // Lengths not adding up to data.
+    data[11] = 2;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateByteData(&mByteDataHandle, data, sizeof(data)));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetByteDataSegments(mByteDataHandle, segments, &count));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetByteDataSegments(mByteDataHandle, NULL, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetByteDataSegments(NULL, segments, &count));
+}
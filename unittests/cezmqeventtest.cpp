@@ -14,7 +14,9 @@
  * limitations under the License.
  *
  *******************************************************************************/
+#include <cstring>
 #include <iostream>
+#include <string>
 
 #include "unittesthelper.h"
 #include "cezmqevent.h"
@@ -111,6 +113,244 @@ TEST_F(CEZMQEventTest, ezmqEventReading)
     ASSERT_EQ(CEZMQ_OK, ezmqEventGetReading(mEventHandle, 0, &mReadingHandle));
 }
 
+TEST_F(CEZMQEventTest, ezmqEventSetAll)
+{
+    CEZMQEventFields fields = {mId, 1, 2, 3, 4, mDevice};
+    ASSERT_EQ(CEZMQ_OK, ezmqEventSetAll(mEventHandle, &fields));
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetID(mEventHandle, &mValue2));
+    EXPECT_STREQ(mId, mValue2);
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetCreated(mEventHandle, &mValue1));
+    EXPECT_EQ(1, mValue1);
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetModified(mEventHandle, &mValue1));
+    EXPECT_EQ(2, mValue1);
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetOrigin(mEventHandle, &mValue1));
+    EXPECT_EQ(3, mValue1);
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetPushed(mEventHandle, &mValue1));
+    EXPECT_EQ(4, mValue1);
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetDevice(mEventHandle, &mValue2));
+    EXPECT_STREQ(mDevice, mValue2);
+
+    fields.device = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqEventSetAll(mEventHandle, &fields));
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetDevice(mEventHandle, &mValue2));
+    EXPECT_STREQ("", mValue2);
+}
+
+TEST_F(CEZMQEventTest, ezmqEventAddReadings)
+{
+    const int count = 50;
+    CEZMQReadingFields readings[count];
+    std::string values[count];
+    for (int i = 0; i < count; i++)
+    {
+        values[i] = std::to_string(i);
+        CEZMQReadingFields fields = {"id", i, 20, 25, 1, "reading", values[i].c_str(), mDevice};
+        readings[i] = fields;
+    }
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateReading(mEventHandle, &mReadingHandle));
+    ASSERT_EQ(CEZMQ_OK, ezmqEventAddReadings(mEventHandle, readings, count));
+    ASSERT_EQ(CEZMQ_OK, ezmqEventAddReadings(mEventHandle, readings, 0));
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetReadingCount(mEventHandle, &mCount));
+    EXPECT_EQ(count + 1, mCount);
+    for (int i = 0; i < count; i++)
+    {
+        ASSERT_EQ(CEZMQ_OK, ezmqEventGetReading(mEventHandle, i + 1, &mReadingHandle));
+        ASSERT_EQ(CEZMQ_OK, ezmqReadingGetCreated(mReadingHandle, &mValue1));
+        EXPECT_EQ(i, mValue1);
+        ASSERT_EQ(CEZMQ_OK, ezmqReadingGetValue(mReadingHandle, &mValue2));
+        EXPECT_STREQ(values[i].c_str(), mValue2);
+        ASSERT_EQ(CEZMQ_OK, ezmqReadingGetDevice(mReadingHandle, &mValue2));
+        EXPECT_STREQ(mDevice, mValue2);
+    }
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventAddReadings(mEventHandle, readings, -1));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventAddReadings(mEventHandle, NULL, 1));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventAddReadings(NULL, readings, 1));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventSetAll(mEventHandle, NULL));
+}
+
+TEST_F(CEZMQEventTest, ezmqEventGetReadings)
+{
+    CEZMQReadingFields readings[3] =
+    {
+        {"id1", 1, 11, 21, 31, "temperature", "25", mDevice},
+        {"id2", 2, 12, 22, 32, "humidity", "40", mDevice},
+        {"id3", 3, 13, 23, 33, "level", "", NULL}
+    };
+    ASSERT_EQ(CEZMQ_OK, ezmqEventAddReadings(mEventHandle, readings, 3));
+
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetReadings(mEventHandle, NULL, 0, &mCount));
+    EXPECT_EQ(3, mCount);
+    CEZMQReadingView views[2];
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetReadings(mEventHandle, views, 2, &mCount));
+    EXPECT_EQ(3, mCount);
+    CEZMQReadingView all[4];
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetReadings(mEventHandle, all, 4, &mCount));
+    EXPECT_EQ(3, mCount);
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(std::string(readings[i].id), std::string(all[i].id, all[i].idLength));
+        EXPECT_EQ(std::string(readings[i].name), std::string(all[i].name, all[i].nameLength));
+        EXPECT_EQ(std::string(readings[i].value), std::string(all[i].value, all[i].valueLength));
+        EXPECT_EQ(readings[i].created, all[i].created);
+        EXPECT_EQ(readings[i].modified, all[i].modified);
+        EXPECT_EQ(readings[i].origin, all[i].origin);
+        EXPECT_EQ(readings[i].pushed, all[i].pushed);
+    }
+    EXPECT_EQ(0, memcmp(&views[1], &all[1], sizeof(CEZMQReadingView)));
+    EXPECT_EQ(0u, all[2].deviceLength);
+
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventGetReadings(mEventHandle, NULL, 1, &mCount));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventGetReadings(mEventHandle, all, -1, &mCount));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventGetReadings(mEventHandle, all, 4, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventGetReadings(NULL, all, 4, &mCount));
+}
+
+TEST_F(CEZMQEventTest, ezmqEventGetReadingColumns)
+{
+    CEZMQReadingFields readings[3] =
+    {
+        {"id1", 1, 11, 21, 31, "temperature", "25", mDevice},
+        {"id2", 2, 12, 22, 32, "humidity", "40", mDevice},
+        {"id3", 3, 13, 23, 33, "level", "7", mDevice}
+    };
+    ASSERT_EQ(CEZMQ_OK, ezmqEventAddReadings(mEventHandle, readings, 3));
+
+    const char *names[3];
+    const char *values[3];
+    size_t valueLengths[3];
+    long created[3];
+    long pushed[3] = {0, 0, 0};
+    CEZMQReadingColumns columns;
+    memset(&columns, 0, sizeof(columns));
+    columns.capacity = 2;
+    columns.names = names;
+    columns.values = values;
+    columns.valueLengths = valueLengths;
+    columns.created = created;
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetReadingColumns(mEventHandle, &columns, &mCount));
+    EXPECT_EQ(3, mCount);
+    for (int i = 0; i < 2; i++)
+    {
+        EXPECT_STREQ(readings[i].name, names[i]);
+        EXPECT_EQ(std::string(readings[i].value), std::string(values[i], valueLengths[i]));
+        EXPECT_EQ(readings[i].created, created[i]);
+    }
+    EXPECT_EQ(0, pushed[0]);
+
+    columns.capacity = 3;
+    columns.pushed = pushed;
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetReadingColumns(mEventHandle, &columns, &mCount));
+    EXPECT_EQ(33, pushed[2]);
+    EXPECT_STREQ("level", names[2]);
+
+    columns.capacity = -1;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventGetReadingColumns(mEventHandle, &columns, &mCount));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventGetReadingColumns(mEventHandle, NULL, &mCount));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventGetReadingColumns(NULL, &columns, &mCount));
+}
+
+TEST_F(CEZMQEventTest, ezmqEventPool)
+{
+    ezmqEventPoolHandle_t pool = NULL;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateEventPool(0, &pool));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateEventPool(1, NULL));
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateEventPool(1, &pool));
+
+    CEZMQEventFields fields = {mId, 1, 2, 3, 4, mDevice};
+    CEZMQReadingFields reading = {"id1", 1, 2, 3, 4, "temperature", "25", mDevice};
+    ezmqEventHandle_t event = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqEventPoolAcquire(pool, &event));
+    ASSERT_EQ(CEZMQ_OK, ezmqEventSetAll(event, &fields));
+    ASSERT_EQ(CEZMQ_OK, ezmqEventAddReadings(event, &reading, 1));
+    ezmqReadingHandle_t first = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetReading(event, 0, &first));
+
+    // Pool is empty, new event is created and destroyed on release as pool is full.
+    ezmqEventHandle_t extra = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqEventPoolAcquire(pool, &extra));
+    EXPECT_NE(event, extra);
+
+    ezmqEventHandle_t released = event;
+    ASSERT_EQ(CEZMQ_OK, ezmqEventPoolRelease(pool, &event));
+    EXPECT_EQ(NULL, event);
+    ASSERT_EQ(CEZMQ_OK, ezmqEventPoolRelease(pool, &extra));
+    EXPECT_EQ(NULL, extra);
+
+    // Released event is cleared and its reading reused.
+    ASSERT_EQ(CEZMQ_OK, ezmqEventPoolAcquire(pool, &event));
+    EXPECT_EQ(released, event);
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetReadingCount(event, &mCount));
+    EXPECT_EQ(0, mCount);
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetID(event, &mValue2));
+    EXPECT_STREQ("", mValue2);
+    ASSERT_EQ(CEZMQ_OK, ezmqEventAddReadings(event, &reading, 1));
+    ezmqReadingHandle_t reused = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetReading(event, 0, &reused));
+    EXPECT_EQ(first, reused);
+
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventPoolRelease(NULL, &event));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventPoolAcquire(pool, NULL));
+    ASSERT_EQ(CEZMQ_OK, ezmqEventPoolRelease(pool, &event));
+    ASSERT_EQ(CEZMQ_OK, ezmqDestroyEventPool(&pool));
+    EXPECT_EQ(NULL, pool);
+    EXPECT_EQ(CEZMQ_ERROR, ezmqDestroyEventPool(&pool));
+}
+
+TEST_F(CEZMQEventTest, ezmqEventArena)
+{
+    ezmqArenaHandle_t arena = NULL;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateArena(0, NULL));
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateArena(64 * 1024, &arena));
+
+    CEZMQEventFields fields = {mId, 1, 2, 3, 4, mDevice};
+    CEZMQReadingFields readings[50];
+    for (int i = 0; i < 50; i++)
+    {
+        CEZMQReadingFields reading = {"id", i, 2, 3, 4, "a reading name longer than small strings", "25", mDevice};
+        readings[i] = reading;
+    }
+    for (int round = 0; round < 3; round++)
+    {
+        ezmqEventHandle_t events[10];
+        for (int i = 0; i < 10; i++)
+        {
+            ASSERT_EQ(CEZMQ_OK, ezmqCreateEventInArena(arena, &events[i]));
+            ASSERT_EQ(CEZMQ_OK, ezmqEventSetAll(events[i], &fields));
+            ASSERT_EQ(CEZMQ_OK, ezmqEventAddReadings(events[i], readings, 50));
+        }
+        for (int i = 0; i < 10; i++)
+        {
+            ASSERT_EQ(CEZMQ_OK, ezmqEventGetReadingCount(events[i], &mCount));
+            EXPECT_EQ(50, mCount);
+            ASSERT_EQ(CEZMQ_OK, ezmqEventGetReading(events[i], 49, &mReadingHandle));
+            ASSERT_EQ(CEZMQ_OK, ezmqReadingGetCreated(mReadingHandle, &mValue1));
+            EXPECT_EQ(49, mValue1);
+        }
+        // Arena events are freed only by arena.
+        EXPECT_EQ(CEZMQ_ERROR, ezmqDestroyEvent(&events[0]));
+        EXPECT_NE((void *) NULL, events[0]);
+        ASSERT_EQ(CEZMQ_OK, ezmqArenaReset(arena));
+    }
+
+    ezmqEventPoolHandle_t pool = NULL;
+    ezmqEventHandle_t event = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateEventPool(1, &pool));
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateEventInArena(arena, &event));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventPoolRelease(pool, &event));
+    ASSERT_EQ(CEZMQ_OK, ezmqDestroyEventPool(&pool));
+
+    // Events left in arena are freed with it.
+    ASSERT_EQ(CEZMQ_OK, ezmqDestroyArena(&arena));
+    EXPECT_EQ(NULL, arena);
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateEventInArena(NULL, &event));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqArenaReset(NULL));
+
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateArena(0, &arena));
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateEventInArena(arena, &event));
+    ASSERT_EQ(CEZMQ_OK, ezmqEventAddReadings(event, readings, 50));
+    ASSERT_EQ(CEZMQ_OK, ezmqDestroyArena(&arena));
+}
+
 TEST_F(CEZMQEventTest, ezmqEventDestroy)
 {
     ezmqEventHandle_t mHandle;
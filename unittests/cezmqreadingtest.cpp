@@ -15,6 +15,7 @@
  *
  *******************************************************************************/
 
+#include <cstring>
 #include <iostream>
 
 #include "unittesthelper.h"
@@ -121,6 +122,64 @@ TEST_F(CEZMQReadingTest, ezmqReadingDevice)
     }
 }
 
+TEST_F(CEZMQReadingTest, ezmqReadingTypedValue)
+{
+    CEZMQValueType type;
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingGetValueType(mReadingHandle, &type));
+    EXPECT_EQ(CEZMQ_VALUE_STRING, type);
+    double number = 0;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReadingGetDouble(mReadingHandle, &number));
+
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingSetValue(mReadingHandle, mValue));
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingSetDouble(mReadingHandle, 23.125));
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingGetValueType(mReadingHandle, &type));
+    EXPECT_EQ(CEZMQ_VALUE_DOUBLE, type);
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingGetDouble(mReadingHandle, &number));
+    EXPECT_EQ(23.125, number);
+    // String value is kept for compatibility.
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingGetValue(mReadingHandle, &mValue2));
+    EXPECT_STREQ(mValue, mValue2);
+
+    // Typed value of other type replaces it.
+    int64_t integer = 0;
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingSetInt64(mReadingHandle, -5000000000LL));
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingGetValueType(mReadingHandle, &type));
+    EXPECT_EQ(CEZMQ_VALUE_INT64, type);
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingGetInt64(mReadingHandle, &integer));
+    EXPECT_EQ(-5000000000LL, integer);
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReadingGetDouble(mReadingHandle, &number));
+
+    int flag = 0;
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingSetBool(mReadingHandle, 7));
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingGetValueType(mReadingHandle, &type));
+    EXPECT_EQ(CEZMQ_VALUE_BOOL, type);
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingGetBool(mReadingHandle, &flag));
+    EXPECT_EQ(1, flag);
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReadingGetInt64(mReadingHandle, &integer));
+
+    uint8_t bytes[] = {0, 1, 0xff, 0x80};
+    const uint8_t *data = NULL;
+    size_t length = 0;
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingSetBytes(mReadingHandle, bytes, sizeof(bytes)));
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingGetValueType(mReadingHandle, &type));
+    EXPECT_EQ(CEZMQ_VALUE_BYTES, type);
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingGetBytes(mReadingHandle, &data, &length));
+    ASSERT_EQ(sizeof(bytes), length);
+    EXPECT_EQ(0, memcmp(bytes, data, length));
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingSetBytes(mReadingHandle, NULL, 0));
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingGetBytes(mReadingHandle, &data, &length));
+    EXPECT_EQ(0u, length);
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReadingSetBytes(mReadingHandle, NULL, 1));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReadingGetBool(mReadingHandle, &flag));
+
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReadingSetDouble(NULL, 1.0));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReadingSetInt64(NULL, 1));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReadingSetBool(NULL, 1));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReadingGetValueType(NULL, &type));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReadingGetValueType(mReadingHandle, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReadingGetBytes(mReadingHandle, &data, NULL));
+}
+
 TEST_F(CEZMQReadingTest, ezmqReadingNegative)
 {
     mEventHandle = NULL;
@@ -16,14 +16,82 @@
  *******************************************************************************/
 
 #include <iostream>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <unistd.h>
 
 #include "unittesthelper.h"
 #include "cezmqapi.h"
 #include "cezmqsubscriber.h"
+#include "cezmqpublisher.h"
 #include "cezmqerrorcodes.h"
 
 static bool isStarted;
 
+// Allocations made by each thread while counting is enabled, to check receive path does
+// not allocate. Counting is enabled only by allocation tests.
+static std::atomic<bool> countAllocations(false);
+static thread_local int threadAllocations;
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    if (countAllocations.load(std::memory_order_relaxed))
+    {
+        threadAllocations++;
+    }
+    return malloc(size ? size : 1);
+}
+
+void *operator new(size_t size)
+{
+    void *memory = operator new(size, std::nothrow);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
 void subCB(const ezmqMsgHandle_t /*event*/, CEZMQContentType /*contentType*/)
 {
     printf("SUB callback \n");
@@ -35,6 +103,188 @@ void subTopicCB(const char * topic, const ezmqMsgHandle_t /*event*/, CEZMQConten
     printf("\nTopic: %s\n", topic);
 }
 
+static std::atomic<int> eventCount;
+static std::atomic<int> topicEventCount;
+
+static void countCB(const ezmqMsgHandle_t /*event*/, CEZMQContentType /*contentType*/)
+{
+    eventCount++;
+}
+
+static void countTopicCB(const char * /*topic*/, const ezmqMsgHandle_t /*event*/,
+        CEZMQContentType /*contentType*/)
+{
+    topicEventCount++;
+}
+
+static void pubCB(CEZMQErrorCode /*code*/){}
+
+static std::atomic<bool> releaseCB;
+static void blockingTopicCB(const char * /*topic*/, const ezmqMsgHandle_t /*event*/,
+        CEZMQContentType /*contentType*/)
+{
+    while (!releaseCB.load())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    topicEventCount++;
+}
+
+static std::mutex callbackLock;
+static std::set<std::thread::id> callbackThreads;
+static void threadTopicCB(const char * /*topic*/, const ezmqMsgHandle_t /*event*/,
+        CEZMQContentType /*contentType*/)
+{
+    {
+        std::lock_guard<std::mutex> lock(callbackLock);
+        callbackThreads.insert(std::this_thread::get_id());
+    }
+    topicEventCount++;
+}
+
+static std::map<std::string, long> lastOrigin;
+static std::atomic<int> outOfOrder;
+static void orderTopicCB(const char *topic, const ezmqMsgHandle_t event, CEZMQContentType /*contentType*/)
+{
+    long origin = 0;
+    ezmqEventGetOrigin(event, &origin);
+    {
+        std::lock_guard<std::mutex> lock(callbackLock);
+        callbackThreads.insert(std::this_thread::get_id());
+        std::map<std::string, long>::iterator it = lastOrigin.find(topic);
+        if (it != lastOrigin.end() && it->second >= origin)
+        {
+            outOfOrder++;
+        }
+        lastOrigin[topic] = origin;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    topicEventCount++;
+}
+
+#define ALLOCATION_EVENTS 300
+typedef struct allocationCheck
+{
+    std::atomic<int> count;
+    int allocations[ALLOCATION_EVENTS];
+    bool valid;
+} allocationCheck;
+
+static void allocationCB(const char *topic, size_t topicLength, const ezmqMsgHandle_t event,
+        CEZMQContentType contentType, size_t size, void *userData)
+{
+    allocationCheck *check = static_cast<allocationCheck *>(userData);
+    int index = check->count.load();
+    if (index < ALLOCATION_EVENTS)
+    {
+        check->allocations[index] = threadAllocations;
+    }
+    check->valid = check->valid && topic && strlen(topic) == topicLength && event &&
+            CEZMQ_CONTENT_TYPE_PROTOBUF == contentType && size > 0;
+    check->count++;
+}
+
+#define SIZE_EVENTS 8
+typedef struct sizeCheck
+{
+    std::atomic<int> count;
+    size_t sizes[SIZE_EVENTS];
+} sizeCheck;
+
+static void sizeCB(const char * /*topic*/, size_t /*topicLength*/, const ezmqMsgHandle_t /*event*/,
+        CEZMQContentType /*contentType*/, size_t size, void *userData)
+{
+    sizeCheck *check = static_cast<sizeCheck *>(userData);
+    int index = check->count.load();
+    if (index < SIZE_EVENTS)
+    {
+        check->sizes[index] = size;
+    }
+    check->count++;
+}
+
+typedef struct segmentCheck
+{
+    std::atomic<int> count;
+    std::vector<std::string> segments;
+} segmentCheck;
+
+static void segmentCB(const char * /*topic*/, size_t /*topicLength*/, const ezmqMsgHandle_t event,
+        CEZMQContentType contentType, size_t /*size*/, void *userData)
+{
+    segmentCheck *check = static_cast<segmentCheck *>(userData);
+    struct iovec segments[4];
+    int count = 4;
+    if (CEZMQ_CONTENT_TYPE_BYTEDATA == contentType &&
+            CEZMQ_OK == ezmqGetByteDataSegments(event, segments, &count))
+    {
+        check->segments.clear();
+        for (int i = 0; i < count; i++)
+        {
+            check->segments.push_back(std::string(static_cast<const char *>(segments[i].iov_base),
+                    segments[i].iov_len));
+        }
+    }
+    check->count++;
+}
+
+#define RETAIN_EVENTS 4
+typedef struct retainCheck
+{
+    ezmqSubHandle_t subscriber;
+    std::atomic<int> count;
+    CEZMQErrorCode results[RETAIN_EVENTS];
+    ezmqMsgHandle_t events[RETAIN_EVENTS];
+    ezmqMsgHandle_t retained[RETAIN_EVENTS];
+} retainCheck;
+
+static void retainCB(const char * /*topic*/, size_t /*topicLength*/, const ezmqMsgHandle_t event,
+        CEZMQContentType /*contentType*/, size_t /*size*/, void *userData)
+{
+    retainCheck *check = static_cast<retainCheck *>(userData);
+    int index = check->count.load();
+    if (index < RETAIN_EVENTS)
+    {
+        check->events[index] = event;
+        check->retained[index] = NULL;
+        check->results[index] = ezmqRetainMessage(check->subscriber, event, &check->retained[index]);
+    }
+    check->count++;
+}
+
+static void routeCB(const char * /*topic*/, size_t /*topicLength*/, const ezmqMsgHandle_t /*event*/,
+        CEZMQContentType /*contentType*/, size_t /*size*/, void *userData)
+{
+    (*static_cast<int *>(userData))++;
+}
+
+static void atomicRouteCB(const char * /*topic*/, size_t /*topicLength*/, const ezmqMsgHandle_t /*event*/,
+        CEZMQContentType /*contentType*/, size_t /*size*/, void *userData)
+{
+    (*static_cast<std::atomic<int> *>(userData))++;
+}
+
+static std::atomic<int> stopResult;
+static void stopSelfCB(const char * /*topic*/, size_t /*topicLength*/, const ezmqMsgHandle_t /*event*/,
+        CEZMQContentType /*contentType*/, size_t /*size*/, void *userData)
+{
+    stopResult = ezmqStopSubscriber(*static_cast<ezmqSubHandle_t *>(userData));
+    topicEventCount++;
+}
+
+static void waitForCount(std::atomic<int> &count, int expected)
+{
+    for (int i = 0; i < 500 && count.load() < expected; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+static std::string getShmEndpoint(const char *name)
+{
+    return std::string("shm://cezmq-test-") + name + "-" + std::to_string(getpid());
+}
+
 class CEZMQSubscriberTest: public TestWithMock
 {
 protected:
@@ -76,6 +326,74 @@ TEST_F(CEZMQSubscriberTest, subCreateSubscriber1)
     ASSERT_EQ(nullptr, instance);
 }
 
+TEST_F(CEZMQSubscriberTest, subCreateSubscriberEx)
+{
+    CEZMQSubOptions options;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(&options, CEZMQ_SUB_OPTIONS_VERSION));
+    EXPECT_EQ(CEZMQ_SUB_OPTIONS_VERSION, options.version);
+    EXPECT_EQ(0, options.dispatchQueueSize);
+    options.dispatchQueueSize = 100;
+    ezmqSubHandle_t instance = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateSubscriberEx(mIp, mPort, &options, subCB, subTopicCB, &instance));
+    ASSERT_NE(nullptr, instance);
+    CEZMQSubOptions effective;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(&effective, CEZMQ_SUB_OPTIONS_VERSION));
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubOptions(instance, &effective));
+    EXPECT_EQ(128, effective.dispatchQueueSize);
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, mTopic));
+    uint64_t dropped;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubDroppedCount(instance, &dropped));
+    EXPECT_EQ(0u, dropped);
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+
+    options.dispatchQueueSize = -1;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberEx(mIp, mPort, &options, subCB, subTopicCB, &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberEx(mIp, mPort, NULL, subCB, subTopicCB, &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetSubOptions(mSubscriber, NULL));
+    ASSERT_EQ(nullptr, instance);
+}
+
+TEST_F(CEZMQSubscriberTest, subOptionsVersion1)
+{
+    // Options of application built with version 1, followed by memory it does not own.
+    struct
+    {
+        int version;
+        int dispatchQueueSize;
+        int guard[8];
+    } v1;
+    memset(&v1, 0x5a, sizeof(v1));
+    CEZMQSubOptions *options = reinterpret_cast<CEZMQSubOptions *>(&v1);
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(options, 1));
+    EXPECT_EQ(1, v1.version);
+    EXPECT_EQ(0, v1.dispatchQueueSize);
+
+    v1.dispatchQueueSize = 100;
+    ezmqSubHandle_t instance = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateSubscriberEx(mIp, mPort, options, subCB, subTopicCB, &instance));
+    ASSERT_NE(nullptr, instance);
+    v1.dispatchQueueSize = 0;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubOptions(instance, options));
+    EXPECT_EQ(1, v1.version);
+    EXPECT_EQ(128, v1.dispatchQueueSize);
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(0x5a5a5a5a, v1.guard[i]);
+    }
+
+    // Unknown versions are not filled.
+    EXPECT_EQ(CEZMQ_ERROR, ezmqInitSubOptions(options, 0));
+    v1.version = 0;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetSubOptions(instance, options));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqInitSubOptions(options, CEZMQ_SUB_OPTIONS_VERSION + 1));
+    v1.version = CEZMQ_SUB_OPTIONS_VERSION + 1;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetSubOptions(instance, options));
+    EXPECT_EQ(128, v1.dispatchQueueSize);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+}
+
 TEST_F(CEZMQSubscriberTest, subDestroySubscriber)
 {
     ezmqSubHandle_t instance = NULL;
@@ -115,6 +433,31 @@ TEST_F(CEZMQSubscriberTest, subSubscribeTopic)
     EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(mSubscriber, mTopic));
 }
 
+TEST_F(CEZMQSubscriberTest, subSubscribeTopicHandle)
+{
+    ezmqTopicHandle_t topicHandle;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopic(mTopic, &topicHandle));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(mSubscriber));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicHandle(mSubscriber, topicHandle));
+    EXPECT_EQ(CEZMQ_OK, ezmqUnSubscribeForTopicHandle(mSubscriber, topicHandle));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqSubscribeForTopicHandle(mSubscriber, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqUnSubscribeForTopicHandle(NULL, topicHandle));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyTopic(&topicHandle));
+}
+
+TEST_F(CEZMQSubscriberTest, subSubscribeTopicSet)
+{
+    const char *topics[] = {"topic1", "topic2", "topic3"};
+    ezmqTopicSetHandle_t topicSet;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopicSet(topics, 3, &topicSet));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(mSubscriber));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicSet(mSubscriber, topicSet));
+    EXPECT_EQ(CEZMQ_OK, ezmqUnSubscribeForTopicSet(mSubscriber, topicSet));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqSubscribeForTopicSet(mSubscriber, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqUnSubscribeForTopicSet(NULL, topicSet));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyTopicSet(&topicSet));
+}
+
 TEST_F(CEZMQSubscriberTest, subSubscribeTopicList)
 {
     EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(mSubscriber));
@@ -257,6 +600,1088 @@ TEST_F(CEZMQSubscriberTest, subGetPort)
     EXPECT_EQ(mPort, port);
 }
 
+TEST_F(CEZMQSubscriberTest, subCreateSubscriberWithEndpoint)
+{
+    ezmqSubHandle_t instance = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint("tcp://localhost:5562", NULL,
+            subCB, subTopicCB, &instance));
+    int port;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubPort(instance, &port));
+    EXPECT_EQ(5562, port);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint("inproc://sub-create", NULL,
+            subCB, subTopicCB, &instance));
+    char *ip;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetSubIp(instance, &ip));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetSubPort(instance, &port));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSubscribeWithIpPort(instance, mIp, mPort, mTopic));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqSubscribeForTopic(instance, "invalid topic"));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+
+    instance = NULL;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberWithEndpoint("ipc:///tmp/sub", NULL,
+            subCB, subTopicCB, &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberWithEndpoint("tcp://localhost", NULL,
+            subCB, subTopicCB, &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberWithEndpoint("inproc://", NULL,
+            subCB, subTopicCB, &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberWithEndpoint("shm://a/b", NULL,
+            subCB, subTopicCB, &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberWithEndpoint(NULL, NULL, subCB, subTopicCB, &instance));
+    ASSERT_EQ(nullptr, instance);
+}
+
+TEST_F(CEZMQSubscriberTest, subInprocReceive)
+{
+    const char *endpoint = "inproc://sub-receive";
+    ezmqSubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint, NULL,
+            countCB, countTopicCB, &instance));
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(&endpoint, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, mTopic));
+
+    eventCount = 0;
+    topicEventCount = 0;
+    ezmqEventHandle_t event = getezmqEvent();
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "topic/child", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "topical", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublish(publisher, event));
+    EXPECT_EQ(2, topicEventCount.load());
+    EXPECT_EQ(0, eventCount.load());
+
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribe(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublish(publisher, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "topical", event));
+    EXPECT_EQ(3, topicEventCount.load());
+    EXPECT_EQ(1, eventCount.load());
+
+    EXPECT_EQ(CEZMQ_OK, ezmqUnSubscribe(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqUnSubscribeForTopic(instance, mTopic));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, event));
+    EXPECT_EQ(3, topicEventCount.load());
+
+    // No delivery once stopped.
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribe(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublish(publisher, event));
+    EXPECT_EQ(1, eventCount.load());
+
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublish(publisher, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+}
+
+TEST_F(CEZMQSubscriberTest, subInprocReceiveQueue)
+{
+    const char *endpoint = "inproc://sub-queue";
+    CEZMQSubOptions options;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(&options, CEZMQ_SUB_OPTIONS_VERSION));
+    options.dispatchQueueSize = 1024;
+    ezmqSubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint, &options,
+            countCB, countTopicCB, &instance));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, mTopic));
+
+    // Publisher can be created after subscriber, ports are not used.
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(&endpoint, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    topicEventCount = 0;
+    uint8_t data[64] = {0};
+    ezmqByteDataHandle_t byteData = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateByteData(&byteData, data, sizeof(data)));
+    for (int i = 0; i < 500; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, byteData));
+    }
+    for (int i = 0; i < 200 && topicEventCount.load() < 500; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(500, topicEventCount.load());
+    uint64_t dropped;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubDroppedCount(instance, &dropped));
+    EXPECT_EQ(0u, dropped);
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyByteData(&byteData));
+}
+
+TEST_F(CEZMQSubscriberTest, subShmReceive)
+{
+    std::string endpoint = getShmEndpoint("receive");
+    const char *endpoints[] = {endpoint.c_str()};
+    ezmqSubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint.c_str(), NULL,
+            countCB, countTopicCB, &instance));
+    // Ring is created by publisher start.
+    EXPECT_EQ(CEZMQ_ERROR, emzqStartSubscriber(instance));
+
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherShmSize(publisher, 256, 512));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSetPublisherShmSize(publisher, 256, 512));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, mTopic));
+
+    eventCount = 0;
+    topicEventCount = 0;
+    ezmqEventHandle_t event = getezmqEvent();
+    uint8_t data[128] = {1, 2, 3};
+    ezmqByteDataHandle_t byteData = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateByteData(&byteData, data, sizeof(data)));
+    for (int i = 0; i < 20; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, event));
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "topic/child", byteData));
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "other", event));
+        EXPECT_EQ(CEZMQ_OK, ezmqPublish(publisher, event));
+    }
+    waitForCount(topicEventCount, 40);
+    EXPECT_EQ(40, topicEventCount.load());
+    EXPECT_EQ(0, eventCount.load());
+    uint64_t gaps;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubGapCount(instance, &gaps));
+    EXPECT_EQ(0u, gaps);
+
+    // Event bigger than ring slot.
+    uint8_t large[1024] = {0};
+    ezmqByteDataHandle_t largeData = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateByteData(&largeData, large, sizeof(large)));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishOnTopic(publisher, mTopic, largeData));
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyByteData(&byteData));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyByteData(&largeData));
+}
+
+TEST_F(CEZMQSubscriberTest, subShmReceivePrepared)
+{
+    std::string endpoint = getShmEndpoint("prepared");
+    const char *endpoints[] = {endpoint.c_str()};
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherAsync(publisher, 64, CEZMQ_QUEUE_BLOCK, 1000));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    ezmqSubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint.c_str(), NULL, countCB, countTopicCB,
+            &instance));
+    sizeCheck check;
+    check.count = 0;
+    EXPECT_EQ(CEZMQ_OK, ezmqSetSubscriberCallbackEx(instance, sizeCB, &check));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, mTopic));
+
+    // Serialized bytes of prepared message parse into same event as published one.
+    ezmqEventHandle_t event = getezmqEvent();
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, event));
+    waitForCount(check.count, 1);
+    ASSERT_EQ(1, check.count.load());
+    size_t size = check.sizes[0];
+    EXPECT_LT(0u, size);
+    ezmqPreparedMsgHandle_t prepared = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreatePreparedMessage(event, &prepared));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishPrepared(publisher, mTopic, prepared));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishPreparedAsync(publisher, mTopic, prepared));
+    EXPECT_EQ(CEZMQ_OK, ezmqFlushPublisher(publisher, 5000));
+    waitForCount(check.count, 3);
+    ASSERT_EQ(3, check.count.load());
+    EXPECT_EQ(size, check.sizes[1]);
+    EXPECT_EQ(size, check.sizes[2]);
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPreparedMessage(&prepared));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+}
+
+TEST_F(CEZMQSubscriberTest, subShmReceiveTopicSet)
+{
+    std::string first = getShmEndpoint("set-first");
+    std::string second = getShmEndpoint("set-second");
+    const char *endpoints[] = {first.c_str(), second.c_str()};
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 2, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    sizeCheck checks[2];
+    ezmqSubHandle_t instances[2] = {NULL, NULL};
+    for (int i = 0; i < 2; i++)
+    {
+        checks[i].count = 0;
+        ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoints[i], NULL, countCB, countTopicCB,
+                &instances[i]));
+        EXPECT_EQ(CEZMQ_OK, ezmqSetSubscriberCallbackEx(instances[i], sizeCB, &checks[i]));
+        EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instances[i]));
+        EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instances[i], mTopic));
+    }
+
+    // Event serialized once for both rings and all the topics.
+    ezmqEventHandle_t event = getezmqEvent();
+    const char *topics[] = {"topic", "other", "topic/set"};
+    ezmqTopicSetHandle_t topicSet = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopicSet(topics, 3, &topicSet));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopicSet(publisher, topicSet, event));
+    for (int i = 0; i < 2; i++)
+    {
+        waitForCount(checks[i].count, 3);
+        ASSERT_EQ(3, checks[i].count.load());
+        EXPECT_LT(0u, checks[i].sizes[0]);
+        EXPECT_EQ(checks[i].sizes[0], checks[i].sizes[1]);
+        EXPECT_EQ(checks[i].sizes[0], checks[i].sizes[2]);
+        EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instances[i]));
+        EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instances[i]));
+    }
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyTopicSet(&topicSet));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+}
+
+TEST_F(CEZMQSubscriberTest, subReceiveByteDataSegments)
+{
+    std::string shmEndpoint = getShmEndpoint("segments");
+    const char *endpoints[] = {"inproc://sub-segments", shmEndpoint.c_str()};
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 2, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    segmentCheck checks[2];
+    ezmqSubHandle_t instances[2] = {NULL, NULL};
+    for (int i = 0; i < 2; i++)
+    {
+        checks[i].count = 0;
+        ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoints[i], NULL, countCB, countTopicCB,
+                &instances[i]));
+        EXPECT_EQ(CEZMQ_OK, ezmqSetSubscriberCallbackEx(instances[i], segmentCB, &checks[i]));
+        EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instances[i]));
+        EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instances[i], mTopic));
+    }
+
+    char header[] = "header";
+    std::string samples(300, 's');
+    struct iovec iov[3];
+    iov[0].iov_base = header;
+    iov[0].iov_len = sizeof(header) - 1;
+    iov[1].iov_base = NULL;
+    iov[1].iov_len = 0;
+    iov[2].iov_base = &samples[0];
+    iov[2].iov_len = samples.size();
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishByteDataV(publisher, mTopic, iov, 3));
+    for (int i = 0; i < 2; i++)
+    {
+        waitForCount(checks[i].count, 1);
+        ASSERT_EQ(1, checks[i].count.load());
+        ASSERT_EQ(3u, checks[i].segments.size());
+        EXPECT_EQ("header", checks[i].segments[0]);
+        EXPECT_EQ("", checks[i].segments[1]);
+        EXPECT_EQ(samples, checks[i].segments[2]);
+        EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instances[i]));
+        EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instances[i]));
+    }
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+}
+
+TEST_F(CEZMQSubscriberTest, subShmGap)
+{
+    std::string endpoint = getShmEndpoint("gap");
+    const char *endpoints[] = {endpoint.c_str()};
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherShmSize(publisher, 8, 256));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    ezmqSubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint.c_str(), NULL,
+            countCB, blockingTopicCB, &instance));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, mTopic));
+
+    // Reader is held in callback of first event while publisher wraps the ring.
+    topicEventCount = 0;
+    releaseCB = false;
+    uint8_t data[16] = {0};
+    ezmqByteDataHandle_t byteData = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateByteData(&byteData, data, sizeof(data)));
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, byteData));
+    }
+    releaseCB = true;
+    uint64_t gaps = 0;
+    for (int i = 0; i < 500; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqGetSubGapCount(instance, &gaps));
+        if (100 == topicEventCount.load() + (int) gaps)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_LT(0u, gaps);
+    EXPECT_EQ(100, topicEventCount.load() + (int) gaps);
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyByteData(&byteData));
+}
+
+TEST_F(CEZMQSubscriberTest, subReceivePull)
+{
+    const char *endpoint = "inproc://sub-pull";
+    CEZMQSubOptions options;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(&options, CEZMQ_SUB_OPTIONS_VERSION));
+    EXPECT_EQ(CEZMQ_RECEIVE_CALLBACK, options.receiveMode);
+    options.receiveMode = CEZMQ_RECEIVE_PULL;
+    ezmqSubHandle_t instance = NULL;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberWithEndpoint(endpoint, &options, NULL, NULL, &instance));
+    options.dispatchQueueSize = 64;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint, &options, NULL, NULL, &instance));
+    CEZMQSubOptions effective;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(&effective, CEZMQ_SUB_OPTIONS_VERSION));
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubOptions(instance, &effective));
+    EXPECT_EQ(CEZMQ_RECEIVE_PULL, effective.receiveMode);
+
+    char *topic = NULL;
+    ezmqMsgHandle_t event = NULL;
+    CEZMQContentType contentType;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSubscriberReceive(instance, 0, &topic, &event, &contentType));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, mTopic));
+    EXPECT_EQ(CEZMQ_TIMEOUT, ezmqSubscriberReceive(instance, 0, &topic, &event, &contentType));
+    EXPECT_EQ(CEZMQ_TIMEOUT, ezmqSubscriberReceive(instance, 20, &topic, &event, &contentType));
+
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(&endpoint, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    ezmqEventHandle_t published = getezmqEvent();
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, published));
+    }
+    ASSERT_EQ(CEZMQ_OK, ezmqSubscriberReceive(instance, 0, &topic, &event, &contentType));
+    EXPECT_STREQ(mTopic, topic);
+    EXPECT_EQ(CEZMQ_CONTENT_TYPE_PROTOBUF, contentType);
+    ASSERT_NE(nullptr, event);
+    // Only events given by subscriber are released.
+    ezmqMsgHandle_t other = published;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReleaseMessage(instance, NULL, &other));
+    EXPECT_EQ(published, other);
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReleaseMessage(mSubscriber, &topic, &event));
+    EXPECT_EQ(CEZMQ_OK, ezmqReleaseMessage(instance, &topic, &event));
+    EXPECT_EQ(nullptr, event);
+    EXPECT_EQ(nullptr, topic);
+
+    CEZMQReceivedMessage messages[10];
+    int count = 0;
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscriberReceiveBatch(instance, 0, messages, 10, &count));
+    EXPECT_EQ(2, count);
+    EXPECT_EQ(CEZMQ_OK, ezmqReleaseMessages(instance, messages, count));
+    EXPECT_EQ(nullptr, messages[1].event);
+    EXPECT_EQ(CEZMQ_TIMEOUT, ezmqSubscriberReceiveBatch(instance, 0, messages, 10, &count));
+    EXPECT_EQ(0, count);
+
+    // Blocked receive returns on publish, and on stop.
+    CEZMQErrorCode result = CEZMQ_ERROR;
+    std::thread receiving([&]() { result = ezmqSubscriberReceive(instance, -1, &topic, &event, &contentType); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, published));
+    receiving.join();
+    EXPECT_EQ(CEZMQ_OK, result);
+    EXPECT_EQ(CEZMQ_OK, ezmqReleaseMessage(instance, &topic, &event));
+    receiving = std::thread([&]() { result = ezmqSubscriberReceive(instance, -1, &topic, &event, &contentType); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    receiving.join();
+    EXPECT_EQ(CEZMQ_ERROR, result);
+
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&published));
+
+    // Subscriber not created in pull mode.
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSubscriberReceive(mSubscriber, 0, &topic, &event, &contentType));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReleaseMessage(mSubscriber, &topic, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReleaseMessage(NULL, &topic, &event));
+}
+
+TEST_F(CEZMQSubscriberTest, subReactor)
+{
+    ezmqReactorHandle_t reactor = NULL;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateReactor(0, &reactor));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateReactor(CEZMQ_REACTOR_MAX_THREADS + 1, &reactor));
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateReactor(2, &reactor));
+
+    CEZMQSubOptions options;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(&options, CEZMQ_SUB_OPTIONS_VERSION));
+    EXPECT_EQ(nullptr, options.reactor);
+    options.reactor = reactor;
+    ezmqSubHandle_t instance = NULL;
+    const char *endpoint = "inproc://sub-reactor";
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberEx(mIp, mPort, &options, countCB, threadTopicCB, &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberWithEndpoint(endpoint, &options, countCB, threadTopicCB, &instance));
+    options.dispatchQueueSize = 256;
+
+    const int subscriberCount = 8;
+    ezmqSubHandle_t subscribers[subscriberCount];
+    for (int i = 0; i < subscriberCount; i++)
+    {
+        ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint, &options, countCB, threadTopicCB,
+                &subscribers[i]));
+        EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(subscribers[i]));
+        EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(subscribers[i], mTopic));
+    }
+    CEZMQSubOptions effective;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(&effective, CEZMQ_SUB_OPTIONS_VERSION));
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubOptions(subscribers[0], &effective));
+    EXPECT_EQ(reactor, effective.reactor);
+
+    // shm subscriber is read by reactor as well.
+    std::string shmEndpoint = getShmEndpoint("reactor");
+    const char *endpoints[] = {endpoint, shmEndpoint.c_str()};
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 2, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    options.dispatchQueueSize = 0;
+    ezmqSubHandle_t shmSubscriber = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(shmEndpoint.c_str(), &options, countCB,
+            threadTopicCB, &shmSubscriber));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(shmSubscriber));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(shmSubscriber, mTopic));
+
+    topicEventCount = 0;
+    callbackThreads.clear();
+    ezmqEventHandle_t published = getezmqEvent();
+    const int eventCount = 100;
+    for (int i = 0; i < eventCount; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, published));
+    }
+    int expected = eventCount * (subscriberCount + 1);
+    waitForCount(topicEventCount, expected);
+    EXPECT_EQ(expected, topicEventCount.load());
+    {
+        std::lock_guard<std::mutex> lock(callbackLock);
+        EXPECT_GE(2u, callbackThreads.size());
+        EXPECT_EQ(0u, callbackThreads.count(std::this_thread::get_id()));
+    }
+
+    // Stopped subscriber is removed from reactor.
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(subscribers[0]));
+    topicEventCount = 0;
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, published));
+    waitForCount(topicEventCount, subscriberCount);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(subscriberCount, topicEventCount.load());
+
+    EXPECT_EQ(CEZMQ_ERROR, ezmqDestroyReactor(&reactor));
+    for (int i = 0; i < subscriberCount; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&subscribers[i]));
+    }
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(shmSubscriber));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&shmSubscriber));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyReactor(&reactor));
+    EXPECT_EQ(nullptr, reactor);
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&published));
+}
+
+TEST_F(CEZMQSubscriberTest, subReactorStopFromCallback)
+{
+    ezmqReactorHandle_t reactor = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateReactor(1, &reactor));
+    CEZMQSubOptions options;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(&options, CEZMQ_SUB_OPTIONS_VERSION));
+    options.reactor = reactor;
+
+    const char *endpoint = "inproc://sub-reactor-stop";
+    std::string shmEndpoint = getShmEndpoint("reactor-stop");
+    const char *endpoints[] = {endpoint, shmEndpoint.c_str()};
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 2, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+
+    // Queued events of inproc subscriber and events read from shm ring by reactor.
+    ezmqSubHandle_t subscribers[2] = {NULL, NULL};
+    options.dispatchQueueSize = 256;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint, &options, countCB, countTopicCB,
+            &subscribers[0]));
+    options.dispatchQueueSize = 0;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(shmEndpoint.c_str(), &options, countCB,
+            countTopicCB, &subscribers[1]));
+    for (int i = 0; i < 2; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(subscribers[i]));
+        EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicWithCallback(subscribers[i], mTopic, stopSelfCB,
+                &subscribers[i]));
+    }
+
+    topicEventCount = 0;
+    stopResult = CEZMQ_ERROR;
+    ezmqEventHandle_t published = getezmqEvent();
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, published));
+    }
+    waitForCount(topicEventCount, 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    // Each subscriber is stopped by its first event, reactor keeps running.
+    EXPECT_EQ(2, topicEventCount.load());
+    EXPECT_EQ(CEZMQ_OK, stopResult.load());
+
+    for (int i = 0; i < 2; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(subscribers[i]));
+    }
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, published));
+    waitForCount(topicEventCount, 4);
+    EXPECT_EQ(4, topicEventCount.load());
+
+    for (int i = 0; i < 2; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(subscribers[i]));
+        EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&subscribers[i]));
+    }
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyReactor(&reactor));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&published));
+}
+
+TEST_F(CEZMQSubscriberTest, subDispatchThreads)
+{
+    const char *endpoint = "inproc://sub-dispatch";
+    CEZMQSubOptions options;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(&options, CEZMQ_SUB_OPTIONS_VERSION));
+    EXPECT_EQ(1, options.dispatchThreads);
+    options.dispatchThreads = 4;
+    ezmqSubHandle_t instance = NULL;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberWithEndpoint(endpoint, &options, countCB, orderTopicCB, &instance));
+    options.dispatchQueueSize = 2000;
+    options.receiveMode = CEZMQ_RECEIVE_PULL;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberWithEndpoint(endpoint, &options, countCB, orderTopicCB, &instance));
+    options.receiveMode = CEZMQ_RECEIVE_CALLBACK;
+    options.dispatchThreads = 0;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateSubscriberWithEndpoint(endpoint, &options, countCB, orderTopicCB, &instance));
+    options.dispatchThreads = 4;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint, &options, countCB, orderTopicCB, &instance));
+    CEZMQSubOptions effective;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(&effective, CEZMQ_SUB_OPTIONS_VERSION));
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubOptions(instance, &effective));
+    EXPECT_EQ(4, effective.dispatchThreads);
+    // Split in 4 queues of 512.
+    EXPECT_EQ(2048, effective.dispatchQueueSize);
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, mTopic));
+
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(&endpoint, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    topicEventCount = 0;
+    outOfOrder = 0;
+    callbackThreads.clear();
+    lastOrigin.clear();
+    ezmqEventHandle_t published = getezmqEvent();
+    const int topicCount = 8;
+    const int eventCount = 50;
+    for (int i = 0; i < eventCount; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqEventSetOrigin(published, i));
+        for (int j = 0; j < topicCount; j++)
+        {
+            std::string topic = std::string(mTopic) + "/" + std::to_string(j);
+            EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, topic.c_str(), published));
+        }
+    }
+    waitForCount(topicEventCount, topicCount * eventCount);
+    EXPECT_EQ(topicCount * eventCount, topicEventCount.load());
+    EXPECT_EQ(0, outOfOrder.load());
+    uint64_t dropped = 1;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubDroppedCount(instance, &dropped));
+    EXPECT_EQ(0u, dropped);
+    {
+        std::lock_guard<std::mutex> lock(callbackLock);
+        EXPECT_EQ(static_cast<size_t>(topicCount), lastOrigin.size());
+        EXPECT_LT(1u, callbackThreads.size());
+        EXPECT_GE(4u, callbackThreads.size());
+    }
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&published));
+}
+
+TEST_F(CEZMQSubscriberTest, subReceiveNoAllocation)
+{
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSetSubscriberCallbackEx(NULL, allocationCB, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSetSubscriberCallbackEx(mSubscriber, NULL, NULL));
+
+    std::string endpoint = getShmEndpoint("allocation");
+    const char *endpoints[] = {endpoint.c_str()};
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    ezmqSubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint.c_str(), NULL, countCB, countTopicCB,
+            &instance));
+    allocationCheck check;
+    check.count = 0;
+    check.valid = true;
+    EXPECT_EQ(CEZMQ_OK, ezmqSetSubscriberCallbackEx(instance, allocationCB, &check));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    // Longer than small string buffer of std::string.
+    const char *topic = "topic/with/name/longer/than/small/string";
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, topic));
+
+    // First events warm up buffers reused for parsing.
+    countAllocations.store(true);
+    const int warmUp = 100;
+    ezmqEventHandle_t event = getezmqEvent();
+    for (int i = 0; i < warmUp; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, topic, event));
+    }
+    waitForCount(check.count, warmUp);
+    for (int i = warmUp; i < ALLOCATION_EVENTS; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, topic, event));
+    }
+    waitForCount(check.count, ALLOCATION_EVENTS);
+    countAllocations.store(false);
+    ASSERT_EQ(ALLOCATION_EVENTS, check.count.load());
+    EXPECT_TRUE(check.valid);
+    EXPECT_EQ(check.allocations[warmUp], check.allocations[ALLOCATION_EVENTS - 1]);
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+}
+
+TEST_F(CEZMQSubscriberTest, subRetainMessage)
+{
+    const char *endpoint = "inproc://sub-retain";
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(&endpoint, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    ezmqEventHandle_t published = getezmqEvent();
+    size_t eventSize = 0;
+    ezmqMsgHandle_t retained = NULL;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqRetainMessage(NULL, published, &retained));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqRetainMessage(mSubscriber, NULL, &retained));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqRetainMessage(mSubscriber, published, NULL));
+
+    // Queued events are retained without copy, within budget.
+    CEZMQSubOptions options;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(&options, CEZMQ_SUB_OPTIONS_VERSION));
+    options.dispatchQueueSize = 16;
+    retainCheck check;
+    check.count = 0;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint, &options, countCB, countTopicCB,
+            &check.subscriber));
+    EXPECT_EQ(CEZMQ_OK, ezmqSetSubscriberCallbackEx(check.subscriber, retainCB, &check));
+    EXPECT_EQ(CEZMQ_OK, ezmqEventSetOrigin(published, 7));
+    EXPECT_EQ(CEZMQ_OK, ezmqRetainMessage(check.subscriber, published, &retained));
+    EXPECT_NE(published, retained);
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubRetainedSize(check.subscriber, &eventSize));
+    EXPECT_LT(0u, eventSize);
+    EXPECT_EQ(CEZMQ_OK, ezmqReleaseMessage(check.subscriber, NULL, &retained));
+    EXPECT_EQ(nullptr, retained);
+    EXPECT_EQ(CEZMQ_OK, ezmqSetSubRetainBudget(check.subscriber, eventSize * 2));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(check.subscriber));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(check.subscriber, mTopic));
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, published));
+    }
+    waitForCount(check.count, 3);
+    ASSERT_EQ(3, check.count.load());
+    EXPECT_EQ(CEZMQ_OK, check.results[0]);
+    EXPECT_EQ(CEZMQ_OK, check.results[1]);
+    EXPECT_EQ(CEZMQ_QUEUE_FULL, check.results[2]);
+    EXPECT_EQ(check.events[0], check.retained[0]);
+    size_t retainedSize = 0;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubRetainedSize(check.subscriber, &retainedSize));
+    EXPECT_EQ(eventSize * 2, retainedSize);
+
+    // Retained event is usable after callback, and after subscriber is stopped.
+    long origin = 0;
+    EXPECT_EQ(CEZMQ_OK, ezmqEventGetOrigin(check.retained[0], &origin));
+    EXPECT_EQ(7, origin);
+    EXPECT_EQ(CEZMQ_OK, ezmqRetainMessage(check.subscriber, check.retained[0], &retained));
+    EXPECT_EQ(check.retained[0], retained);
+    EXPECT_EQ(CEZMQ_OK, ezmqReleaseMessage(check.subscriber, NULL, &check.retained[0]));
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubRetainedSize(check.subscriber, &retainedSize));
+    EXPECT_EQ(eventSize * 2, retainedSize);
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(check.subscriber));
+    EXPECT_EQ(CEZMQ_OK, ezmqEventGetOrigin(retained, &origin));
+    EXPECT_EQ(CEZMQ_OK, ezmqReleaseMessage(check.subscriber, NULL, &retained));
+    // Released event is not known any more, event not released is freed with subscriber.
+    ezmqMsgHandle_t released = check.events[0];
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReleaseMessage(check.subscriber, NULL, &released));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqReleaseMessage(check.subscriber, NULL, &published));
+    EXPECT_NE(nullptr, published);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&check.subscriber));
+
+    // Event given on publishing thread is copied.
+    check.count = 0;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint, NULL, countCB, countTopicCB,
+            &check.subscriber));
+    EXPECT_EQ(CEZMQ_OK, ezmqSetSubscriberCallbackEx(check.subscriber, retainCB, &check));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(check.subscriber));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(check.subscriber, mTopic));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, published));
+    ASSERT_EQ(1, check.count.load());
+    EXPECT_EQ(CEZMQ_OK, check.results[0]);
+    EXPECT_NE(check.events[0], check.retained[0]);
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubRetainedSize(check.subscriber, &retainedSize));
+    EXPECT_EQ(eventSize, retainedSize);
+    EXPECT_EQ(CEZMQ_OK, ezmqReleaseMessage(check.subscriber, NULL, &check.retained[0]));
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubRetainedSize(check.subscriber, &retainedSize));
+    EXPECT_EQ(0u, retainedSize);
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(check.subscriber));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&check.subscriber));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&published));
+}
+
+TEST_F(CEZMQSubscriberTest, subTopicCallbacks)
+{
+    const char *endpoint = "inproc://sub-routes";
+    ezmqSubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint, NULL, countCB, countTopicCB, &instance));
+    const int topicCount = 1000;
+    static int counts[topicCount];
+    int specific = 0;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSubscribeForTopicWithCallback(instance, "site/0", NULL, NULL));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqSubscribeForTopicWithCallback(instance, NULL, routeCB, NULL));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqSubscribeForTopicWithCallback(instance, "site/#", routeCB, NULL));
+    for (int i = 0; i < topicCount; i++)
+    {
+        counts[i] = 0;
+        std::string topic = "site/" + std::to_string(i);
+        EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicWithCallback(instance, topic.c_str(), routeCB, &counts[i]));
+    }
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicWithCallback(instance, "site/1/temp/", routeCB, &specific));
+
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(&endpoint, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    eventCount = 0;
+    topicEventCount = 0;
+    ezmqEventHandle_t event = getezmqEvent();
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/5", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/10", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/1/humidity", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/1/temp", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/1/temp/room", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/1/temperature", event));
+    EXPECT_EQ(1, counts[5]);
+    EXPECT_EQ(1, counts[10]);
+    EXPECT_EQ(2, counts[1]);
+    EXPECT_EQ(2, specific);
+    EXPECT_EQ(0, counts[0]);
+    EXPECT_EQ(0, topicEventCount.load());
+
+    // Callback is replaced, and removed by un-subscribe.
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicWithCallback(instance, "site/5", routeCB, &specific));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/5", event));
+    EXPECT_EQ(1, counts[5]);
+    EXPECT_EQ(3, specific);
+    EXPECT_EQ(CEZMQ_OK, ezmqUnSubscribeForTopic(instance, "site/1/temp"));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/1/temp", event));
+    EXPECT_EQ(3, counts[1]);
+    EXPECT_EQ(3, specific);
+
+    // Callback is kept till last subscription of the topic is removed.
+    EXPECT_EQ(CEZMQ_OK, ezmqUnSubscribeForTopic(instance, "site/5"));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/5", event));
+    EXPECT_EQ(4, specific);
+    EXPECT_EQ(CEZMQ_OK, ezmqUnSubscribeForTopic(instance, "site/5"));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/5", event));
+    EXPECT_EQ(4, specific);
+    EXPECT_EQ(1, counts[5]);
+
+    // Events of topics without callback go to subscriber callbacks.
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, "other"));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "other", event));
+    EXPECT_EQ(1, topicEventCount.load());
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+}
+
+TEST_F(CEZMQSubscriberTest, subTopicCallbacksChanged)
+{
+    const char *endpoint = "inproc://sub-routes-changed";
+    ezmqSubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint, NULL, countCB, countTopicCB, &instance));
+    std::atomic<int> routed(0);
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicWithCallback(instance, "site/1", atomicRouteCB, &routed));
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(&endpoint, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+
+    // Events are looked up on publishing threads while routes are changed, each change
+    // replaces the copy of tables they read.
+    ezmqEventHandle_t event = getezmqEvent();
+    const int threadCount = 4;
+    const int eventCount = 500;
+    std::vector<std::thread> publishing;
+    for (int i = 0; i < threadCount; i++)
+    {
+        publishing.push_back(std::thread([&]()
+        {
+            for (int j = 0; j < eventCount; j++)
+            {
+                ezmqPublishOnTopic(publisher, "site/1", event);
+            }
+        }));
+    }
+    int other = 0;
+    for (int i = 0; i < 200; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicWithCallback(instance, "site/2", routeCB, &other));
+        EXPECT_EQ(CEZMQ_OK, ezmqUnSubscribeForTopic(instance, "site/2"));
+    }
+    for (size_t i = 0; i < publishing.size(); i++)
+    {
+        publishing[i].join();
+    }
+    EXPECT_EQ(threadCount * eventCount, routed.load());
+    EXPECT_EQ(0, other);
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+}
+
+static std::atomic<int> typedEventCount;
+static double typedValue;
+
+static void typedValueCB(const char * /*topic*/, const ezmqMsgHandle_t event, CEZMQContentType /*contentType*/)
+{
+    ezmqReadingHandle_t reading = NULL;
+    CEZMQValueType type = CEZMQ_VALUE_STRING;
+    if (CEZMQ_OK == ezmqEventGetReading(event, 0, &reading) &&
+            CEZMQ_OK == ezmqReadingGetValueType(reading, &type) && CEZMQ_VALUE_DOUBLE == type)
+    {
+        ezmqReadingGetDouble(reading, &typedValue);
+    }
+    typedEventCount++;
+}
+
+TEST_F(CEZMQSubscriberTest, subShmTypedValue)
+{
+    std::string endpoint = getShmEndpoint("typed");
+    const char *endpoints[] = {endpoint.c_str()};
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    ezmqSubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint.c_str(), NULL, countCB, typedValueCB, &instance));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, mTopic));
+
+    // Typed value survives serialization into the ring and parsing by the reader.
+    typedEventCount = 0;
+    typedValue = 0;
+    ezmqEventHandle_t event = getezmqEvent();
+    ezmqReadingHandle_t reading = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqEventGetReading(event, 0, &reading));
+    ASSERT_EQ(CEZMQ_OK, ezmqReadingSetDouble(reading, -273.15));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, event));
+    waitForCount(typedEventCount, 1);
+    EXPECT_EQ(1, typedEventCount.load());
+    EXPECT_EQ(-273.15, typedValue);
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+}
+
+TEST_F(CEZMQSubscriberTest, subTopicPatterns)
+{
+    const char *endpoint = "inproc://sub-patterns";
+    ezmqSubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint, NULL, countCB, countTopicCB, &instance));
+    int temperature = 0;
+    int area = 0;
+    int any = 0;
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqSubscribeForTopicPattern(instance, NULL, routeCB, NULL));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqSubscribeForTopicPattern(instance, "", routeCB, NULL));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqSubscribeForTopicPattern(instance, "site/#/temp", routeCB, NULL));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqSubscribeForTopicPattern(instance, "site/a*/temp", routeCB, NULL));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqUnSubscribeForTopicPattern(instance, "site/*/temp"));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicPattern(instance, "site/*/temp", routeCB, &temperature));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicPattern(instance, "area/1/#", routeCB, &area));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicPattern(instance, "*/2/humidity", routeCB, &any));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicPattern(instance, "area/*/level", NULL, NULL));
+
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(&endpoint, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    eventCount = 0;
+    topicEventCount = 0;
+    ezmqEventHandle_t event = getezmqEvent();
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/1/temp", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/22/temp", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/1/temp/room", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/1/humidity", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "area/1", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "area/1/a/b/c", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "area/2/humidity", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "area/2/level", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "area/2/other", event));
+    EXPECT_EQ(2, temperature);
+    EXPECT_EQ(2, area);
+    EXPECT_EQ(1, any);
+    // Events matching pattern without callback go to subscriber callbacks, others are dropped.
+    EXPECT_EQ(1, topicEventCount.load());
+
+    // Subscribed topic takes events under pattern prefix which match no pattern.
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, "area/2/other"));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "area/2/other", event));
+    EXPECT_EQ(2, topicEventCount.load());
+    EXPECT_EQ(CEZMQ_OK, ezmqUnSubscribeForTopic(instance, "area/2/other"));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "area/2/other", event));
+    EXPECT_EQ(2, topicEventCount.load());
+
+    // Callback is replaced, and pattern removed by un-subscribe.
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopicPattern(instance, "site/*/temp", routeCB, &area));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/3/temp", event));
+    EXPECT_EQ(2, temperature);
+    EXPECT_EQ(3, area);
+    EXPECT_EQ(CEZMQ_OK, ezmqUnSubscribeForTopicPattern(instance, "site/*/temp"));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, "site/3/temp", event));
+    EXPECT_EQ(3, area);
+    EXPECT_EQ(2, topicEventCount.load());
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+}
+
+static bool isReadable(int fd)
+{
+    struct pollfd item;
+    item.fd = fd;
+    item.events = POLLIN;
+    item.revents = 0;
+    return (1 == poll(&item, 1, 0)) && (item.revents & POLLIN);
+}
+
+TEST_F(CEZMQSubscriberTest, subPollFd)
+{
+    const char *endpoint = "inproc://sub-fd";
+    int fd = -1;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetSubscriberFd(mSubscriber, &fd));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetSubscriberFd(NULL, &fd));
+
+    CEZMQSubOptions options;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitSubOptions(&options, CEZMQ_SUB_OPTIONS_VERSION));
+    options.receiveMode = CEZMQ_RECEIVE_PULL;
+    options.dispatchQueueSize = 64;
+    ezmqSubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateSubscriberWithEndpoint(endpoint, &options, NULL, NULL, &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetSubscriberFd(instance, NULL));
+    ASSERT_EQ(CEZMQ_OK, ezmqGetSubscriberFd(instance, &fd));
+    int again = -1;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetSubscriberFd(instance, &again));
+    EXPECT_EQ(fd, again);
+    EXPECT_EQ(CEZMQ_OK, emzqStartSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqSubscribeForTopic(instance, mTopic));
+    EXPECT_FALSE(isReadable(fd));
+
+    ezmqPubHandle_t publisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(&endpoint, 1, pubCB, pubCB, pubCB, &publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(publisher));
+    ezmqEventHandle_t published = getezmqEvent();
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, published));
+    }
+    EXPECT_TRUE(isReadable(fd));
+
+    // Fd stays readable till queue is seen empty.
+    char *topic = NULL;
+    ezmqMsgHandle_t event = NULL;
+    CEZMQContentType contentType;
+    ASSERT_EQ(CEZMQ_OK, ezmqSubscriberReceive(instance, 0, &topic, &event, &contentType));
+    EXPECT_EQ(CEZMQ_OK, ezmqReleaseMessage(instance, &topic, &event));
+    EXPECT_TRUE(isReadable(fd));
+    int received = 0;
+    while (CEZMQ_OK == ezmqSubscriberReceive(instance, 0, &topic, &event, &contentType))
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqReleaseMessage(instance, &topic, &event));
+        received++;
+    }
+    EXPECT_EQ(2, received);
+    EXPECT_FALSE(isReadable(fd));
+
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, published));
+    EXPECT_TRUE(isReadable(fd));
+
+    // Batch draining the queue clears fd too.
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, published));
+    CEZMQReceivedMessage messages[4];
+    int count = 0;
+    ASSERT_EQ(CEZMQ_OK, ezmqSubscriberReceiveBatch(instance, 0, messages, 4, &count));
+    EXPECT_EQ(2, count);
+    for (int i = 0; i < count; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqReleaseMessage(instance, &messages[i].topic, &messages[i].event));
+    }
+    EXPECT_FALSE(isReadable(fd));
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStopSubscriber(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroySubscriber(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&publisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&published));
+}
+
 TEST_F(CEZMQSubscriberTest, subNegative)
 {
     const char **topicList = NULL;
@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <iostream>
+#include <string.h>
+
+#include "unittesthelper.h"
+#include "cezmqtopic.h"
+#include "cezmqerrorcodes.h"
+
+class CEZMQTopicTest: public TestWithMock
+{
+protected:
+    void SetUp()
+    {
+        mTopicHandle = NULL;
+        TestWithMock::SetUp();
+    }
+
+    void TearDown()
+    {
+        if(mTopicHandle != NULL)
+        {
+            ASSERT_EQ(CEZMQ_OK, ezmqDestroyTopic(&mTopicHandle));
+        }
+        TestWithMock::TearDown();
+    }
+    ezmqTopicHandle_t mTopicHandle;
+    const char * mTopic = "home/livingroom/";
+};
+
+TEST_F(CEZMQTopicTest, createTopic)
+{
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopic(mTopic, &mTopicHandle));
+    ASSERT_NE(nullptr, mTopicHandle);
+}
+
+TEST_F(CEZMQTopicTest, createTopicInterned)
+{
+    ezmqTopicHandle_t topicHandle = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopic(mTopic, &mTopicHandle));
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopic(mTopic, &topicHandle));
+    ASSERT_EQ(mTopicHandle, topicHandle);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyTopic(&topicHandle));
+    ASSERT_EQ(nullptr, topicHandle);
+
+    char *topic;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetTopicName(mTopicHandle, &topic));
+    EXPECT_EQ(0, strcmp(mTopic, topic));
+}
+
+TEST_F(CEZMQTopicTest, createTopicInvalid)
+{
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqCreateTopic("", &mTopicHandle));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqCreateTopic("home/#/", &mTopicHandle));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqCreateTopic("home livingroom", &mTopicHandle));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqCreateTopic(NULL, &mTopicHandle));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateTopic(mTopic, NULL));
+    ASSERT_EQ(nullptr, mTopicHandle);
+}
+
+TEST_F(CEZMQTopicTest, getTopicName)
+{
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopic(mTopic, &mTopicHandle));
+    char *topic;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetTopicName(mTopicHandle, &topic));
+    EXPECT_EQ(0, strcmp(mTopic, topic));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetTopicName(NULL, &topic));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetTopicName(mTopicHandle, NULL));
+}
+
+TEST_F(CEZMQTopicTest, destroyTopic)
+{
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopic(mTopic, &mTopicHandle));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyTopic(&mTopicHandle));
+    ASSERT_EQ(nullptr, mTopicHandle);
+    EXPECT_EQ(CEZMQ_ERROR, ezmqDestroyTopic(&mTopicHandle));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqDestroyTopic(NULL));
+}
+
+TEST_F(CEZMQTopicTest, createTopicSet)
+{
+    const char *topics[] = {"home/livingroom/", "home/kitchen/", "home/bedroom/"};
+    ezmqTopicSetHandle_t topicSet = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopicSet(topics, 3, &topicSet));
+    ASSERT_NE(nullptr, topicSet);
+    int size;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetTopicSetSize(topicSet, &size));
+    EXPECT_EQ(3, size);
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetTopicSetSize(topicSet, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetTopicSetSize(NULL, &size));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyTopicSet(&topicSet));
+    ASSERT_EQ(nullptr, topicSet);
+    EXPECT_EQ(CEZMQ_ERROR, ezmqDestroyTopicSet(&topicSet));
+}
+
+TEST_F(CEZMQTopicTest, createTopicSetInvalid)
+{
+    const char *topics[] = {"home/livingroom/", "home/#/"};
+    ezmqTopicSetHandle_t topicSet = NULL;
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqCreateTopicSet(topics, 2, &topicSet));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqCreateTopicSet(topics, 0, &topicSet));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqCreateTopicSet(NULL, 1, &topicSet));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreateTopicSet(topics, 1, NULL));
+    ASSERT_EQ(nullptr, topicSet);
+}
@@ -16,6 +16,11 @@
  *******************************************************************************/
 
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "unittesthelper.h"
 #include "cezmqapi.h"
@@ -29,6 +34,21 @@ void startCB(CEZMQErrorCode /*code*/){}
 void stopCB(CEZMQErrorCode /*code*/){}
 void errorCB(CEZMQErrorCode /*code*/){}
 
+static std::atomic<int> freeCount;
+static void freeByteData(uint8_t *data, void * /*hint*/)
+{
+    delete[] data;
+    freeCount++;
+}
+
+static ezmqByteDataHandle_t getNoCopyByteData()
+{
+    ezmqByteDataHandle_t dataHandle = NULL;
+    uint8_t *buffer = new uint8_t[1024]();
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateLocalByteDataNoCopy(&dataHandle, buffer, 1024, freeByteData, NULL));
+    return dataHandle;
+}
+
 class CEZMQPublisherTest: public TestWithMock
 {
     protected:
@@ -69,6 +89,70 @@ TEST_F(CEZMQPublisherTest, pubCreatePublisher1)
     ASSERT_EQ(nullptr, instance);
 }
 
+TEST_F(CEZMQPublisherTest, pubCreatePublisherEx)
+{
+    CEZMQPubOptions options;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitPubOptions(&options, CEZMQ_PUB_OPTIONS_VERSION));
+    EXPECT_EQ(CEZMQ_PUB_OPTIONS_VERSION, options.version);
+    ezmqPubHandle_t instance = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreatePublisherEx(mPort, &options, startCB, stopCB, errorCB, &instance));
+    ASSERT_NE(nullptr, instance);
+    CEZMQPubOptions effective;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitPubOptions(&effective, CEZMQ_PUB_OPTIONS_VERSION));
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubOptions(instance, &effective));
+    EXPECT_EQ(0, effective.asyncQueueSize);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&instance));
+
+    EXPECT_EQ(CEZMQ_ERROR, ezmqInitPubOptions(&options, CEZMQ_PUB_OPTIONS_VERSION + 1));
+    options.version = CEZMQ_PUB_OPTIONS_VERSION + 1;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreatePublisherEx(mPort, &options, startCB, stopCB, errorCB, &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqInitPubOptions(&options, 0));
+    EXPECT_EQ(CEZMQ_OK, ezmqInitPubOptions(&options, CEZMQ_PUB_OPTIONS_VERSION));
+    options.asyncQueueSize = -1;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreatePublisherEx(mPort, &options, startCB, stopCB, errorCB, &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreatePublisherEx(mPort, NULL, startCB, stopCB, errorCB, &instance));
+    ASSERT_EQ(nullptr, instance);
+}
+
+TEST_F(CEZMQPublisherTest, pubCreatePublisherExAsyncQueue)
+{
+    CEZMQPubOptions options;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitPubOptions(&options, CEZMQ_PUB_OPTIONS_VERSION));
+    options.asyncQueueSize = 6;
+    options.flushTimeout = 500;
+    ezmqPubHandle_t instance = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreatePublisherEx(mPort, &options, startCB, stopCB, errorCB, &instance));
+    CEZMQPubOptions effective;
+    EXPECT_EQ(CEZMQ_OK, ezmqInitPubOptions(&effective, CEZMQ_PUB_OPTIONS_VERSION));
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubOptions(instance, &effective));
+    EXPECT_EQ(8, effective.asyncQueueSize);
+    EXPECT_EQ(CEZMQ_QUEUE_DROP_NEWEST, effective.asyncQueuePolicy);
+    EXPECT_EQ(500, effective.flushTimeout);
+
+    // Publisher is not started, so nothing is sent: events beyond queue size are not queued.
+    int accepted = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        ezmqEventHandle_t event = getezmqEvent();
+        if (CEZMQ_OK == ezmqPublishAsync(instance, mTopic, event))
+        {
+            accepted++;
+        }
+        else
+        {
+            EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+        }
+    }
+    EXPECT_EQ(8, accepted);
+    int size;
+    uint64_t dropped;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubQueueSize(instance, &size));
+    EXPECT_EQ(8, size);
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubDroppedCount(instance, &dropped));
+    EXPECT_EQ(92u, dropped);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&instance));
+}
+
 TEST_F(CEZMQPublisherTest, pubDestroyPublisher)
 {
     ezmqPubHandle_t instance = NULL;
@@ -82,6 +166,89 @@ TEST_F(CEZMQPublisherTest, pubDestroyPublisher1)
     EXPECT_EQ(CEZMQ_ERROR, ezmqDestroyPublisher(NULL));
 }
 
+TEST_F(CEZMQPublisherTest, pubCreatePublisherWithEndpoints)
+{
+    ezmqPubHandle_t instance = NULL;
+    std::string tcp = "tcp://*:" + std::to_string(mPort);
+    const char *endpoints[] = {tcp.c_str(), "inproc://pub-create", "inproc://pub-create-1"};
+    EXPECT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 3, startCB, stopCB, errorCB, &instance));
+    int port;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubPort(instance, &port));
+    EXPECT_EQ(mPort, port);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&instance));
+
+    EXPECT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints + 1, 2, startCB, stopCB, errorCB,
+            &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetPubPort(instance, &port));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSetServerPrivateKey(instance, "key"));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&instance));
+
+    instance = NULL;
+    const char *twoTcp[] = {tcp.c_str(), "tcp://*:5000"};
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreatePublisherWithEndpoints(twoTcp, 2, startCB, stopCB, errorCB, &instance));
+    const char *invalid[] = {"ipc:///tmp/pub", "tcp://localhost:5000", "tcp://*:port", "inproc:/pub",
+            "shm://..", "shm://a/b", NULL};
+    for (int i = 0; i < 7; i++)
+    {
+        EXPECT_EQ(CEZMQ_ERROR, ezmqCreatePublisherWithEndpoints(invalid + i, 1, startCB, stopCB, errorCB,
+                &instance));
+    }
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreatePublisherWithEndpoints(endpoints, 0, startCB, stopCB, errorCB, &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqCreatePublisherWithEndpoints(NULL, 1, startCB, stopCB, errorCB, &instance));
+    ASSERT_EQ(nullptr, instance);
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishInproc)
+{
+    const char *endpoint = "inproc://pub-publish";
+    ezmqPubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(&endpoint, 1, startCB, stopCB, errorCB, &instance));
+    ezmqEventHandle_t event = getezmqEvent();
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishOnTopic(instance, mTopic, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(instance, mTopic, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublish(instance, event));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqPublishOnTopic(instance, "invalid topic", event));
+
+    // Only one publisher can be bound to an endpoint.
+    ezmqPubHandle_t second = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(&endpoint, 1, startCB, stopCB, errorCB, &second));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqStartPublisher(second));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublish(instance, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(second));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublish(second, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(second));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&second));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishShm)
+{
+    std::string endpoint = "shm://cezmq-test-pub-" + std::to_string(mPort);
+    const char *endpoints[] = {endpoint.c_str(), "inproc://pub-shm"};
+    ezmqPubHandle_t instance = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 2, startCB, stopCB, errorCB, &instance));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSetPublisherShmSize(instance, 1, 1024));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSetPublisherShmSize(instance, 16, 0));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSetPublisherShmSize(NULL, 16, 1024));
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherShmSize(instance, 16, 1024));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(instance));
+    ezmqEventHandle_t event = getezmqEvent();
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(instance, mTopic, event));
+    }
+    // Ring is kept across restart.
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublish(instance, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&instance));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+}
+
 TEST_F(CEZMQPublisherTest, pubStartstop)
 {
     for( int i =1; i<=10; i++)
@@ -128,6 +295,97 @@ TEST_F(CEZMQPublisherTest, pubPublishByteDataOnTopic)
     EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(mPublisher, mTopic, event));
 }
 
+TEST_F(CEZMQPublisherTest, pubPublishByteDataNoCopy)
+{
+    freeCount = 0;
+    ezmqByteDataHandle_t event = getNoCopyByteData();
+    ASSERT_NE(nullptr, event);
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(mPublisher, mTopic, event));
+    EXPECT_EQ(1, freeCount);
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(mPublisher, mTopic, event));
+    size_t size;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetDataLength(event, &size));
+    EXPECT_EQ(1024u, size);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyByteData(&event));
+    EXPECT_EQ(1, freeCount);
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishLocalByteDataNoCopy)
+{
+    // Buffer is read in place by shm publisher, it is freed only by destroy.
+    std::string endpoint = "shm://cezmq-test-pub-local-" + std::to_string(mPort);
+    const char *endpoints[] = {endpoint.c_str()};
+    ezmqPubHandle_t shmPublisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 1, startCB, stopCB, errorCB,
+            &shmPublisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(shmPublisher));
+    freeCount = 0;
+    ezmqByteDataHandle_t event = getNoCopyByteData();
+    ASSERT_NE(nullptr, event);
+    uint8_t *buffer = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetByteData(event, &buffer));
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(shmPublisher, mTopic, event));
+    }
+    EXPECT_EQ(0, freeCount.load());
+    uint8_t *data = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetByteData(event, &data));
+    EXPECT_EQ(buffer, data);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyByteData(&event));
+    EXPECT_EQ(1, freeCount.load());
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(shmPublisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&shmPublisher));
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishByteDataNoCopyConcurrent)
+{
+    // Same byte data published from several threads, on tcp [detach] and shm [reads buffer].
+    std::string endpoint = "shm://cezmq-test-pub-nocopy-" + std::to_string(mPort);
+    const char *endpoints[] = {endpoint.c_str()};
+    ezmqPubHandle_t shmPublisher = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreatePublisherWithEndpoints(endpoints, 1, startCB, stopCB, errorCB,
+            &shmPublisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(shmPublisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+
+    freeCount = 0;
+    const int rounds = 200;
+    const int threadCount = 4;
+    for (int round = 0; round < rounds; round++)
+    {
+        ezmqByteDataHandle_t event = getNoCopyByteData();
+        ASSERT_NE(nullptr, event);
+        std::atomic<bool> go(false);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < threadCount; i++)
+        {
+            threads.push_back(std::thread([&, i]()
+            {
+                while (!go.load())
+                {
+                }
+                ezmqPubHandle_t publisher = (i % 2) ? shmPublisher : mPublisher;
+                EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(publisher, mTopic, event));
+            }));
+        }
+        go.store(true);
+        for (size_t i = 0; i < threads.size(); i++)
+        {
+            threads[i].join();
+        }
+        EXPECT_EQ(round + 1, freeCount.load());
+        uint8_t *data = NULL;
+        EXPECT_EQ(CEZMQ_OK, ezmqGetByteData(event, &data));
+        EXPECT_EQ(0, data[1023]);
+        EXPECT_EQ(CEZMQ_OK, ezmqDestroyByteData(&event));
+    }
+    EXPECT_EQ(rounds, freeCount.load());
+    EXPECT_EQ(CEZMQ_OK, ezmqStopPublisher(shmPublisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPublisher(&shmPublisher));
+}
+
 TEST_F(CEZMQPublisherTest, pubPublishOnTopic1)
 {
     ezmqEventHandle_t event = getezmqEvent();
@@ -221,6 +479,437 @@ TEST_F(CEZMQPublisherTest, pubPublishTopicList)
     }
 }
 
+TEST_F(CEZMQPublisherTest, pubPublishOnTopicHandle)
+{
+    ezmqTopicHandle_t topicHandle;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopic(mTopic, &topicHandle));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopicHandle(mPublisher, topicHandle, getezmqEvent()));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopicHandle(mPublisher, topicHandle, getezmqByteData()));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqPublishOnTopicHandle(mPublisher, NULL, getezmqEvent()));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishOnTopicHandle(NULL, topicHandle, getezmqEvent()));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyTopic(&topicHandle));
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishOnTopicSet)
+{
+    const char *topics[] = {"topic1", "topic2", "topic3"};
+    ezmqTopicSetHandle_t topicSet;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopicSet(topics, 3, &topicSet));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopicSet(mPublisher, topicSet, getezmqEvent()));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopicSet(mPublisher, topicSet, getezmqByteData()));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqPublishOnTopicSet(mPublisher, NULL, getezmqEvent()));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishOnTopicSet(NULL, topicSet, getezmqEvent()));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyTopicSet(&topicSet));
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishByteDataV)
+{
+    uint8_t header[] = { 0x40, 0x05 };
+    std::vector<uint8_t> samples(4096, 0x11);
+    struct iovec iov[3];
+    iov[0].iov_base = header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = samples.data();
+    iov[1].iov_len = samples.size();
+    iov[2].iov_base = NULL;
+    iov[2].iov_len = 0;
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishByteDataV(mPublisher, mTopic, iov, 3));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishByteDataV(mPublisher, NULL, iov, 1));
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqPublishByteDataV(mPublisher, "", iov, 3));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishByteDataV(mPublisher, mTopic, iov, 0));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishByteDataV(mPublisher, mTopic, NULL, 3));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishByteDataV(NULL, mTopic, iov, 3));
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishBatch)
+{
+    ezmqEventHandle_t event = getezmqEvent();
+    ASSERT_NE(nullptr, event);
+    ezmqByteDataHandle_t byteData = getezmqByteData();
+    ASSERT_NE(nullptr, byteData);
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    ezmqMsgHandle_t events[3] = {event, byteData, event};
+    CEZMQErrorCode results[3];
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishBatch(mPublisher, NULL, events, 3, results));
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, results[i]);
+    }
+
+    const char *topics[3] = {"topic1", NULL, "topic2"};
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishBatch(mPublisher, topics, events, 3, results));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishBatch(mPublisher, topics, events, 3, NULL));
+
+    // Invalid entries should not fail rest of the batch
+    topics[1] = "";
+    events[2] = NULL;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishBatch(mPublisher, topics, events, 3, results));
+    EXPECT_EQ(CEZMQ_OK, results[0]);
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, results[1]);
+    EXPECT_EQ(CEZMQ_ERROR, results[2]);
+
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishBatch(NULL, topics, events, 3, results));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishBatch(mPublisher, topics, NULL, 3, results));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishBatch(mPublisher, topics, events, 0, results));
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishAsync)
+{
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishAsync(mPublisher, mTopic, getezmqEvent()));
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherAsync(mPublisher, 64, CEZMQ_QUEUE_BLOCK, 1000));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSetPublisherAsync(mPublisher, 64, CEZMQ_QUEUE_BLOCK, 1000));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    isStarted = true;
+
+    for (int i = 0; i < 200; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishAsync(mPublisher, mTopic, getezmqEvent()));
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishAsync(mPublisher, NULL, getezmqByteData()));
+    }
+    EXPECT_EQ(CEZMQ_OK, ezmqFlushPublisher(mPublisher, 5000));
+    int size;
+    uint64_t dropped;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubQueueSize(mPublisher, &size));
+    EXPECT_EQ(0, size);
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubDroppedCount(mPublisher, &dropped));
+    EXPECT_EQ(0u, dropped);
+
+    ezmqEventHandle_t event = getezmqEvent();
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqPublishAsync(mPublisher, "", event));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishAsync(mPublisher, mTopic, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishAsync(NULL, mTopic, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishAsyncOnTopicHandle)
+{
+    ezmqTopicHandle_t topicHandle;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopic(mTopic, &topicHandle));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishAsyncOnTopicHandle(mPublisher, topicHandle, getezmqEvent()));
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherAsync(mPublisher, 64, CEZMQ_QUEUE_BLOCK, 1000));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    isStarted = true;
+
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishAsyncOnTopicHandle(mPublisher, topicHandle, getezmqEvent()));
+    }
+    // Queued events keep the topic alive.
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyTopic(&topicHandle));
+    EXPECT_EQ(CEZMQ_OK, ezmqFlushPublisher(mPublisher, 5000));
+    uint64_t dropped;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubDroppedCount(mPublisher, &dropped));
+    EXPECT_EQ(0u, dropped);
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishAsyncByteDataNoCopy)
+{
+    freeCount = 0;
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherAsync(mPublisher, 64, CEZMQ_QUEUE_BLOCK, 1000));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    isStarted = true;
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishAsync(mPublisher, mTopic, getNoCopyByteData()));
+    }
+    EXPECT_EQ(CEZMQ_OK, ezmqFlushPublisher(mPublisher, 5000));
+    EXPECT_EQ(100, freeCount);
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishAsyncMultiThread)
+{
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherAsync(mPublisher, 16, CEZMQ_QUEUE_BLOCK, 1000));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    isStarted = true;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+    {
+        threads.push_back(std::thread([this]()
+        {
+            for (int j = 0; j < 250; j++)
+            {
+                EXPECT_EQ(CEZMQ_OK, ezmqPublishAsync(mPublisher, mTopic, getezmqEvent()));
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+    EXPECT_EQ(CEZMQ_OK, ezmqFlushPublisher(mPublisher, 5000));
+    uint64_t dropped;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubDroppedCount(mPublisher, &dropped));
+    EXPECT_EQ(0u, dropped);
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishAsyncDropNewest)
+{
+    // Publisher is not started, so queue is not drained.
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherAsync(mPublisher, 2, CEZMQ_QUEUE_DROP_NEWEST, 0));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishAsync(mPublisher, mTopic, getezmqEvent()));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishAsync(mPublisher, mTopic, getezmqEvent()));
+    ezmqEventHandle_t event = getezmqEvent();
+    EXPECT_EQ(CEZMQ_QUEUE_FULL, ezmqPublishAsync(mPublisher, mTopic, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+
+    int size;
+    uint64_t dropped;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubQueueSize(mPublisher, &size));
+    EXPECT_EQ(2, size);
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubDroppedCount(mPublisher, &dropped));
+    EXPECT_EQ(1u, dropped);
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishAsyncDropOldest)
+{
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherAsync(mPublisher, 2, CEZMQ_QUEUE_DROP_OLDEST, 0));
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishAsync(mPublisher, mTopic, getezmqEvent()));
+    }
+    int size;
+    uint64_t dropped;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubQueueSize(mPublisher, &size));
+    EXPECT_EQ(2, size);
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubDroppedCount(mPublisher, &dropped));
+    EXPECT_EQ(3u, dropped);
+
+    // Queued events are sent once publisher is started.
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    isStarted = true;
+    EXPECT_EQ(CEZMQ_OK, ezmqFlushPublisher(mPublisher, 5000));
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubQueueSize(mPublisher, &size));
+    EXPECT_EQ(0, size);
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishAsyncConflate)
+{
+    freeCount = 0;
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherAsync(mPublisher, 2, CEZMQ_QUEUE_CONFLATE, 0));
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishAsync(mPublisher, "topic1", getNoCopyByteData()));
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishAsync(mPublisher, "topic2", getezmqEvent()));
+    }
+    int size;
+    uint64_t dropped;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubQueueSize(mPublisher, &size));
+    EXPECT_EQ(2, size);
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubDroppedCount(mPublisher, &dropped));
+    EXPECT_EQ(8u, dropped);
+    // Replaced events are destroyed right away.
+    EXPECT_EQ(4, freeCount);
+
+    // Queue is full of waiting topics.
+    ezmqEventHandle_t event = getezmqEvent();
+    EXPECT_EQ(CEZMQ_QUEUE_FULL, ezmqPublishAsync(mPublisher, "topic3", event));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    isStarted = true;
+    EXPECT_EQ(CEZMQ_OK, ezmqFlushPublisher(mPublisher, 5000));
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubQueueSize(mPublisher, &size));
+    EXPECT_EQ(0, size);
+    EXPECT_EQ(5, freeCount);
+
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishAsync(mPublisher, "topic3", getezmqEvent()));
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishAsync(mPublisher, NULL, getezmqByteData()));
+    }
+    EXPECT_EQ(CEZMQ_OK, ezmqFlushPublisher(mPublisher, 5000));
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubQueueSize(mPublisher, &size));
+    EXPECT_EQ(0, size);
+}
+
+TEST_F(CEZMQPublisherTest, pubRateLimit)
+{
+    CEZMQRateLimit limit = { 10, 3, 0, 0 };
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherRateLimit(mPublisher, &limit));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    ezmqEventHandle_t event = getezmqEvent();
+    // Rejected publishes do not take tokens.
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqPublishOnTopic(mPublisher, "invalid topic", event));
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(mPublisher, mTopic, event));
+    }
+    EXPECT_EQ(CEZMQ_RATE_LIMITED, ezmqPublishOnTopic(mPublisher, mTopic, event));
+    EXPECT_EQ(CEZMQ_RATE_LIMITED, ezmqPublish(mPublisher, event));
+    uint64_t rejected, paced;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubRateLimitCount(mPublisher, &rejected, &paced));
+    EXPECT_EQ(2u, rejected);
+    EXPECT_EQ(0u, paced);
+
+    // Token is refilled after 1/10 second.
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublish(mPublisher, event));
+
+    // Remove the limit.
+    limit = { 0, 0, 0, 0 };
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherRateLimit(mPublisher, &limit));
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublish(mPublisher, event));
+    }
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqSetPublisherRateLimit(mPublisher, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqGetPubRateLimitCount(mPublisher, NULL, &paced));
+}
+
+TEST_F(CEZMQPublisherTest, pubRateLimitBytes)
+{
+    CEZMQRateLimit limit = { 0, 0, 1000, 2048 };
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherRateLimit(mPublisher, &limit));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    ezmqByteDataHandle_t event = getNoCopyByteData();
+    EXPECT_EQ(CEZMQ_OK, ezmqPublish(mPublisher, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublish(mPublisher, event));
+    EXPECT_EQ(CEZMQ_RATE_LIMITED, ezmqPublish(mPublisher, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyByteData(&event));
+}
+
+TEST_F(CEZMQPublisherTest, pubRateLimitTopic)
+{
+    ezmqTopicHandle_t topicHandle;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopic("ratelimit/topic", &topicHandle));
+    CEZMQRateLimit limit = { 10, 1, 0, 0 };
+    EXPECT_EQ(CEZMQ_OK, ezmqSetTopicRateLimit(topicHandle, &limit));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    ezmqEventHandle_t event = getezmqEvent();
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopicHandle(mPublisher, topicHandle, event));
+    EXPECT_EQ(CEZMQ_RATE_LIMITED, ezmqPublishOnTopicHandle(mPublisher, topicHandle, event));
+    // Same limit for topic published by name.
+    EXPECT_EQ(CEZMQ_RATE_LIMITED, ezmqPublishOnTopic(mPublisher, "ratelimit/topic", event));
+    // Other topics are not limited.
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishOnTopic(mPublisher, mTopic, event));
+    uint64_t rejected, paced;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetTopicRateLimitCount(topicHandle, &rejected, &paced));
+    EXPECT_EQ(2u, rejected);
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubRateLimitCount(mPublisher, &rejected, &paced));
+    EXPECT_EQ(0u, rejected);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyTopic(&topicHandle));
+}
+
+TEST_F(CEZMQPublisherTest, pubRateLimitAsync)
+{
+    CEZMQRateLimit limit = { 200, 5, 0, 0 };
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherRateLimit(mPublisher, &limit));
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherAsync(mPublisher, 64, CEZMQ_QUEUE_BLOCK, 1000));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    isStarted = true;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 25; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishAsync(mPublisher, mTopic, getezmqEvent()));
+    }
+    EXPECT_EQ(CEZMQ_OK, ezmqFlushPublisher(mPublisher, 5000));
+    // 5 events in burst, remaining 20 paced at 200/s.
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(90));
+    uint64_t rejected, paced, dropped;
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubRateLimitCount(mPublisher, &rejected, &paced));
+    EXPECT_EQ(0u, rejected);
+    EXPECT_GT(paced, 0u);
+    EXPECT_EQ(CEZMQ_OK, ezmqGetPubDroppedCount(mPublisher, &dropped));
+    EXPECT_EQ(0u, dropped);
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishPrepared)
+{
+    ezmqEventHandle_t event = getezmqEvent();
+    ASSERT_NE(nullptr, event);
+    ezmqByteDataHandle_t byteData = getezmqByteData();
+    ASSERT_NE(nullptr, byteData);
+
+    ezmqPreparedMsgHandle_t preparedEvent = NULL;
+    ezmqPreparedMsgHandle_t preparedData = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreatePreparedMessage(byteData, &preparedData));
+    EXPECT_EQ(CEZMQ_OK, ezmqEventFreeze(&event, &preparedEvent));
+    EXPECT_EQ(nullptr, event);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyByteData(&byteData));
+
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishPrepared(mPublisher, NULL, preparedEvent));
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishPrepared(mPublisher, mTopic, preparedEvent));
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishPrepared(mPublisher, "topic/status", preparedData));
+    }
+    EXPECT_EQ(CEZMQ_INVALID_TOPIC, ezmqPublishPrepared(mPublisher, "", preparedEvent));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishPrepared(mPublisher, mTopic, NULL));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishPrepared(NULL, mTopic, preparedEvent));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventFreeze(&event, &preparedEvent));
+
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPreparedMessage(&preparedEvent));
+    EXPECT_EQ(nullptr, preparedEvent);
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPreparedMessage(&preparedData));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqDestroyPreparedMessage(&preparedData));
+}
+
+TEST_F(CEZMQPublisherTest, pubPublishPreparedAsync)
+{
+    ezmqPreparedMsgHandle_t prepared = NULL;
+    ezmqEventHandle_t event = getezmqEvent();
+    ASSERT_NE(nullptr, event);
+    EXPECT_EQ(CEZMQ_OK, ezmqCreatePreparedMessage(event, &prepared));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyEvent(&event));
+
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishPreparedAsync(mPublisher, mTopic, prepared));
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherAsync(mPublisher, 8, CEZMQ_QUEUE_DROP_OLDEST, 1000));
+    for (int i = 0; i < 20; i++)
+    {
+        EXPECT_EQ(CEZMQ_OK, ezmqPublishPreparedAsync(mPublisher, mTopic, prepared));
+    }
+
+    // Queue keeps prepared message alive after application destroys it.
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPreparedMessage(&prepared));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    isStarted = true;
+    EXPECT_EQ(CEZMQ_OK, ezmqFlushPublisher(mPublisher, 5000));
+}
+
+TEST_F(CEZMQPublisherTest, pubArenaEventOwnership)
+{
+    ezmqArenaHandle_t arena = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateArena(4096, &arena));
+    ezmqEventHandle_t event = NULL;
+    ASSERT_EQ(CEZMQ_OK, ezmqCreateEventInArena(arena, &event));
+    EXPECT_EQ(CEZMQ_OK, ezmqEventSetID(event, "id"));
+    ezmqTopicHandle_t topicHandle = NULL;
+    EXPECT_EQ(CEZMQ_OK, ezmqCreateTopic(mTopic, &topicHandle));
+    EXPECT_EQ(CEZMQ_OK, ezmqSetPublisherAsync(mPublisher, 8, CEZMQ_QUEUE_BLOCK, 1000));
+    EXPECT_EQ(CEZMQ_OK, ezmqStartPublisher(mPublisher));
+    isStarted = true;
+
+    // Arena frees its events, publisher can not take ownership of them.
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishAsync(mPublisher, mTopic, event));
+    EXPECT_EQ(CEZMQ_ERROR, ezmqPublishAsyncOnTopicHandle(mPublisher, topicHandle, event));
+    ezmqPreparedMsgHandle_t prepared = NULL;
+    EXPECT_EQ(CEZMQ_ERROR, ezmqEventFreeze(&event, &prepared));
+    EXPECT_NE(nullptr, event);
+    EXPECT_EQ(nullptr, prepared);
+
+    // Copy and synchronous publish are fine.
+    EXPECT_EQ(CEZMQ_OK, ezmqPublish(mPublisher, event));
+    EXPECT_EQ(CEZMQ_OK, ezmqCreatePreparedMessage(event, &prepared));
+    EXPECT_EQ(CEZMQ_OK, ezmqArenaReset(arena));
+    EXPECT_EQ(CEZMQ_OK, ezmqPublishPrepared(mPublisher, mTopic, prepared));
+    EXPECT_EQ(CEZMQ_OK, ezmqFlushPublisher(mPublisher, 5000));
+
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyPreparedMessage(&prepared));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyTopic(&topicHandle));
+    EXPECT_EQ(CEZMQ_OK, ezmqDestroyArena(&arena));
+}
+
 TEST_F(CEZMQPublisherTest, publishSecure)
 {
     const char *serverSecretKey = "[:X%Q3UfY+kv2A^.wv:(qy2E=bk0L][cm=mS3Hcx";